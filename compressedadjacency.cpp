@@ -0,0 +1,129 @@
+//--------------------------compressedadjacency.cpp--------------------------
+//Purpose: Implementation file for CompressedAdjacency class. Stores sorted
+//         neighbor lists as variable-length gaps in one byte array (see
+//         compressedadjacency.h for the encoding).
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include "compressedadjacency.h"
+using namespace std;
+
+//--------------------------CompressedAdjacency------------------------------
+//Description: Empty Constructor - no nodes, unweighted.
+//---------------------------------------------------------------------------
+CompressedAdjacency::CompressedAdjacency()
+{
+  clear(false);
+} //end of CompressedAdjacency
+
+//-------------------------~CompressedAdjacency------------------------------
+//Description: Destructor.
+//---------------------------------------------------------------------------
+CompressedAdjacency::~CompressedAdjacency()
+{
+} //end of ~CompressedAdjacency
+
+//---------------------------------clear-------------------------------------
+//Description: Public function to remove every list, ready for node 1 to be
+//             added, with or without weights.
+//---------------------------------------------------------------------------
+void CompressedAdjacency::clear(const bool weighted)
+{
+  this->weighted = weighted;
+  this->edgeCount = 0;
+  bytes.clear();
+  start.assign(2, 0); //Node 0 is unused, and has an empty list
+} //end of clear
+
+//--------------------------------addNode------------------------------------
+//Description: Public function to add the list of the next node (the first
+//             call adds node 1). Receives the (neighbor, weight) pairs of the
+//             node, which are sorted in place; weights are ignored on an
+//             unweighted graph.
+//---------------------------------------------------------------------------
+void CompressedAdjacency::addNode(vector<pair<int, int> > &edges)
+{
+  encodeList(edges, weighted, bytes);
+  start.push_back(bytes.size());
+  edgeCount += edges.size();
+} //end of addNode
+
+//-------------------------------neighbors-----------------------------------
+//Description: Public function to return a Cursor over the list of node v.
+//---------------------------------------------------------------------------
+CompressedAdjacency::Cursor CompressedAdjacency::neighbors(const int v) const
+{
+  const unsigned char *base = bytes.empty() ? nullptr : &bytes[0];
+  return makeCursor(base + start[v], base + start[v + 1], weighted);
+} //end of neighbors
+
+//--------------------------------getSize------------------------------------
+//Description: Public function to return the number of nodes added.
+//---------------------------------------------------------------------------
+int CompressedAdjacency::getSize() const
+{
+  return start.size() - 2;
+} //end of getSize
+
+//-----------------------------getEdgeCount----------------------------------
+//Description: Public function to return the number of edges added.
+//---------------------------------------------------------------------------
+long CompressedAdjacency::getEdgeCount() const
+{
+  return edgeCount;
+} //end of getEdgeCount
+
+//-------------------------------getBytes------------------------------------
+//Description: Public function to return the memory used by the lists and
+//             their offsets, in bytes.
+//---------------------------------------------------------------------------
+long CompressedAdjacency::getBytes() const
+{
+  return bytes.size() + start.size() * sizeof(size_t);
+} //end of getBytes
+
+//------------------------------encodeList-----------------------------------
+//Description: Public utility function to sort one node's (neighbor, weight)
+//             pairs and append their encoding to out.
+//---------------------------------------------------------------------------
+void CompressedAdjacency::encodeList(vector<pair<int, int> > &edges, const bool weighted,
+                                     vector<unsigned char> &out)
+{
+  sort(edges.begin(), edges.end());
+  unsigned last = 0;
+  for (size_t i = 0; i < edges.size(); i++)
+  {
+    encode(edges[i].first - last, out); //Gap from the previous neighbor
+    last = edges[i].first;
+    if (weighted)
+    {
+      encode(edges[i].second, out);
+    }
+  }
+} //end of encodeList
+
+//------------------------------makeCursor-----------------------------------
+//Description: Public utility function to make a Cursor over one encoded
+//             list held anywhere in memory.
+//---------------------------------------------------------------------------
+CompressedAdjacency::Cursor CompressedAdjacency::makeCursor(const unsigned char *begin,
+                                                            const unsigned char *end,
+                                                            const bool weighted)
+{
+  Cursor cursor = {begin, end, 0, weighted};
+  return cursor;
+} //end of makeCursor
+
+//---------------------------------encode------------------------------------
+//Description: Public utility function to append one variable-length
+//             integer to out, low 7 bits first.
+//---------------------------------------------------------------------------
+void CompressedAdjacency::encode(const unsigned value, vector<unsigned char> &out)
+{
+  unsigned rest = value;
+  while (rest >= 0x80)
+  {
+    out.push_back((unsigned char)(rest | 0x80));
+    rest >>= 7;
+  }
+  out.push_back((unsigned char)rest);
+} //end of encode
@@ -0,0 +1,118 @@
+//--------------------------compressedadjacency.h----------------------------
+//Purpose: Header file for CompressedAdjacency class. CompressedAdjacency
+//         stores the neighbor list of every node in one byte array. Each
+//         list is sorted, and stored as the gaps between neighbors, each
+//         gap (and weight, if the graph is weighted) written as a
+//         variable-length integer: 7 bits per byte, with the high bit set
+//         on every byte but the last. Sparse graphs with nearby neighbor
+//         numbers take one or two bytes per edge.
+//---------------------------------------------------------------------------
+//Notes: Lists are decoded on the fly with a Cursor, which only needs the
+//       bytes of one list, so the same format is used for the lists GraphX
+//       keeps in its adjacency file. Cursor::next is defined here so that
+//       searches can inline it.
+//---------------------------------------------------------------------------
+#ifndef COMPRESSEDADJACENCY_H
+#define COMPRESSEDADJACENCY_H
+#include <cstddef>
+#include <utility>
+#include <vector>
+using namespace std;
+
+class CompressedAdjacency
+{
+public:
+  struct Cursor
+  {
+    const unsigned char *pos; //Next byte to decode
+    const unsigned char *end; //One past the last byte of the list
+    unsigned last;            //Previous neighbor, 0 before the first
+    bool weighted;            //Whether a weight follows each gap
+    bool next(int &target, int &weight);
+    bool decode(unsigned &value);
+  };
+
+  //Constructors
+  CompressedAdjacency();
+  ~CompressedAdjacency();
+  //Getters
+  Cursor neighbors(const int v) const;
+  int getSize() const;
+  long getEdgeCount() const;
+  long getBytes() const;
+  //Setters
+  void clear(const bool weighted);
+  void addNode(vector<pair<int, int> > &edges);
+  //Utility
+  static void encodeList(vector<pair<int, int> > &edges, const bool weighted,
+                         vector<unsigned char> &out);
+  static Cursor makeCursor(const unsigned char *begin, const unsigned char *end,
+                           const bool weighted);
+  static void encode(const unsigned value, vector<unsigned char> &out);
+
+private:
+  vector<unsigned char> bytes; //Every list, one after another
+  vector<size_t> start;        //List of v is bytes start[v] to start[v + 1]
+  bool weighted;
+  long edgeCount;
+};
+
+//---------------------------------next--------------------------------------
+//Description: Decodes the next neighbor of the list, and its weight (1 if
+//             the list has no weights). Returns false at the end of the list,
+//             or where the list is cut short.
+//---------------------------------------------------------------------------
+inline bool CompressedAdjacency::Cursor::next(int &target, int &weight)
+{
+  unsigned value;
+  if (!decode(value))
+  {
+    return false;
+  }
+  last += value;
+  target = last;
+  weight = 1;
+  if (weighted)
+  {
+    unsigned cost;
+    if (!decode(cost))
+    {
+      return false;
+    }
+    weight = cost;
+  }
+  return true;
+} //end of next
+
+//--------------------------------decode-------------------------------------
+//Description: Decodes one variable-length integer. Returns false, and ends
+//             the list, if the bytes run out or the integer is longer than
+//             32 bits, which only a damaged list can hold.
+//---------------------------------------------------------------------------
+inline bool CompressedAdjacency::Cursor::decode(unsigned &value)
+{
+  if (pos == end)
+  {
+    return false;
+  }
+  value = *pos++;
+  if (value >= 0x80)
+  { //More than one byte, so gather 7 bits at a time
+    value &= 0x7F;
+    int shift = 7;
+    unsigned char byte;
+    do
+    {
+      if (pos == end || shift > 28)
+      {
+        pos = end;
+        return false;
+      }
+      byte = *pos++;
+      value |= (unsigned)(byte & 0x7F) << shift;
+      shift += 7;
+    } while (byte >= 0x80);
+  }
+  return true;
+} //end of decode
+#endif
@@ -0,0 +1,39 @@
+//---------------------------------------------------------------------------
+// graphd.cpp
+//---------------------------------------------------------------------------
+// Runs a GraphServer: loads the GraphM graphs and GraphL graphs once, then
+// answers requests for them over a Unix domain socket until stopped with
+// SIGINT or SIGTERM. SIGHUP reloads both files.
+//
+// Usage: graphd socket matrixfile listfile [workers]
+//   e.g. graphd /tmp/graphs.sock data31.txt data32.txt 4
+//
+// Assumptions:
+//   -- both files are formatted as lab3 expects
+//   -- workers defaults to the number of hardware threads
+//---------------------------------------------------------------------------
+
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include "graphserver.h"
+using namespace std;
+
+int main(int argc, char *argv[]) {
+	if (argc < 4) {
+		cout << "Usage: " << argv[0] << " socket matrixfile listfile [workers]" << endl;
+		return 1;
+	}
+	int workers = (argc > 4) ? atoi(argv[4]) : (int)thread::hardware_concurrency();
+
+	GraphServer server(argv[1], argv[2], argv[3], workers);
+	if (!server.loadGraphs()) {
+		cout << "File could not be opened." << endl;
+		return 1;
+	}
+	if (!server.run()) {
+		cout << "Socket could not be opened." << endl;
+		return 1;
+	}
+	return 0;
+}
@@ -13,6 +13,7 @@
 //       provides proper data checking and overloads appropriate operators
 //       for comparison, and the file being provided is formatted correctly.
 //---------------------------------------------------------------------------
+#include <algorithm>
 #include "graphl.h"
 using namespace std;
 
@@ -22,6 +23,10 @@ using namespace std;
 GraphL::GraphL()
 {
   this->size = 0;
+  this->componentCount = 0;
+  this->closureWords = 0;
+  this->compressed = false;
+  this->listBytes = 0;
 } //end of GraphL
 
 //-------------------------------~GraphL-------------------------------------
@@ -54,10 +59,12 @@ GraphL::~GraphL()
 //             Receives the file ifstream oject from a main driver, and first
 //             establishes the number of nodes in the graph (int), followed by
 //             the location (string), then finally the starting node, and its
-//             adjacent edge node. Assumption: Data in the .txt file is
-//             properly formatted.
+//             adjacent edge node. If compressed is true, the edges are
+//             gathered into one array and encoded into a CompressedAdjacency
+//             without building any EdgeNodes. Assumption: Data in the .txt
+//             file is properly formatted.
 //---------------------------------------------------------------------------
-bool GraphL::buildGraph(ifstream &inFile)
+bool GraphL::buildGraph(ifstream &inFile, const bool compressed)
 {
   inFile >> this->size; //Establish size based on number of nodes
   int fromNode, toNode;
@@ -77,6 +84,7 @@ bool GraphL::buildGraph(ifstream &inFile)
       nodes[i].edgeHead = nullptr;    //then assign it to the data in the Node
       nodes[i].visited = false;
     }
+    vector<pair<int, int> > edges; //Edges read so far, if compressed
     for (;;) //Loop until broken
     {
       inFile >> fromNode >> toNode; //Assign each variable
@@ -88,8 +96,22 @@ bool GraphL::buildGraph(ifstream &inFile)
       {
         break;
       }
+      if (compressed)
+      { //Keep the edges insertEdge would keep, to encode once all are read
+        if (fromNode != toNode && fromNode >= 1 && fromNode <= size &&
+            toNode >= 1 && toNode <= size)
+        {
+          edges.push_back(make_pair(fromNode, toNode));
+        }
+        continue;
+      }
       insertEdge(fromNode, toNode); //Call private function to insert the Edge
     }                               //as an EdgeNode
+    if (compressed)
+    {
+      encodeEdges(edges);
+    }
+    buildReachability(); //Index the finished graph for reachable
   }
   return true;
 } //end of buildGraph
@@ -119,13 +141,491 @@ bool GraphL::insertEdge(const int fromNode, const int toNode)
   return false;
 } //end of insertEdge
 
+//-----------------------------encodeEdges-----------------------------------
+//Description: Private helper function for buildGraph to sort the (from, to)
+//             edges read from the file by starting node, encode each node's
+//             edges into compressedEdges, and free the array.
+//---------------------------------------------------------------------------
+void GraphL::encodeEdges(vector<pair<int, int> > &edges)
+{
+  sort(edges.begin(), edges.end());
+  compressedEdges.clear(false);
+  listBytes = edges.size() * sizeof(EdgeNode); //What the lists would have used
+  vector<pair<int, int> > list; //Edges of one node, reused for each
+  size_t e = 0;
+  for (int i = 1; i <= this->size; i++)
+  {
+    list.clear();
+    for (; e < edges.size() && edges[e].first == i; e++)
+    {
+      list.push_back(make_pair(edges[e].second, 1));
+    }
+    compressedEdges.addNode(list);
+  }
+  vector<pair<int, int> >().swap(edges);
+  compressed = true;
+} //end of encodeEdges
+
+//-------------------------------edgesOf-------------------------------------
+//Description: Private helper function to return a cursor at the first edge
+//             of node v, in either the linked list or the compressed list.
+//---------------------------------------------------------------------------
+GraphL::EdgeCursor GraphL::edgesOf(const int v) const
+{
+  EdgeCursor cursor;
+  cursor.edge = nodes[v].edgeHead;
+  if (compressed)
+  {
+    cursor.list = compressedEdges.neighbors(v);
+  }
+  return cursor;
+} //end of edgesOf
+
+//-------------------------------nextEdge------------------------------------
+//Description: Private helper function to read the adjacent node of the next
+//             edge at a cursor. Returns false once every edge has been read.
+//---------------------------------------------------------------------------
+bool GraphL::nextEdge(EdgeCursor &cursor, int &w) const
+{
+  if (compressed)
+  {
+    int weight;
+    return cursor.list.next(w, weight);
+  }
+  if (cursor.edge == nullptr)
+  {
+    return false;
+  }
+  w = cursor.edge->adjGraphNode;
+  cursor.edge = cursor.edge->nextEdge;
+  return true;
+} //end of nextEdge
+
+//--------------------------buildReachability--------------------------------
+//Description: Private helper function to build the reachability index.
+//             First condenses each strongly connected component into one
+//             node (Tarjan's algorithm, iterative so deep graphs cannot
+//             overflow the call stack). Components finish in reverse
+//             topological order, so every edge of the condensed graph goes
+//             from a higher component to a lower one. Up to CLOSURELIMIT
+//             components, the full transitive closure is stored one bit per
+//             pair. Above that, only the condensed graph is kept, with
+//             LABELINGS interval labels per component, each from a post-order
+//             traversal in a different order (see labelTraversal).
+//---------------------------------------------------------------------------
+void GraphL::buildReachability()
+{
+  vector<int> order(size + 1, -1); //Visit order of each node, -1 if unvisited
+  vector<int> lowLink(size + 1, 0); //Lowest order reachable on the stack
+  vector<bool> onStack(size + 1, false);
+  vector<int> sccStack;             //Nodes whose component is not yet known
+  vector<pair<int, EdgeCursor> > callStack; //Node and its next edge to follow
+  int counter = 0;
+  component.assign(size + 1, -1);
+  componentCount = 0;
+  for (int s = 1; s <= size; s++)
+  {
+    if (order[s] != -1)
+    {
+      continue; //Already in a component
+    }
+    order[s] = lowLink[s] = counter++;
+    sccStack.push_back(s);
+    onStack[s] = true;
+    callStack.push_back(make_pair(s, edgesOf(s)));
+    while (!callStack.empty())
+    {
+      int v = callStack.back().first;
+      int w;
+      if (nextEdge(callStack.back().second, w))
+      { //Follow the next edge of v
+        if (order[w] == -1)
+        { //Unvisited, so descend into it
+          order[w] = lowLink[w] = counter++;
+          sccStack.push_back(w);
+          onStack[w] = true;
+          callStack.push_back(make_pair(w, edgesOf(w)));
+        }
+        else if (onStack[w])
+        {
+          lowLink[v] = min(lowLink[v], order[w]);
+        }
+      }
+      else
+      { //Every edge of v followed, so return to its parent
+        callStack.pop_back();
+        if (!callStack.empty())
+        {
+          int parent = callStack.back().first;
+          lowLink[parent] = min(lowLink[parent], lowLink[v]);
+        }
+        if (lowLink[v] == order[v])
+        { //v is the root of a component, which is everything above it
+          int w;
+          do
+          {
+            w = sccStack.back();
+            sccStack.pop_back();
+            onStack[w] = false;
+            component[w] = componentCount;
+          } while (w != v);
+          componentCount++;
+        }
+      }
+    }
+  }
+
+  vector<int> members(size);               //Nodes sorted by component
+  vector<int> memberStart(componentCount + 1, 0);
+  for (int v = 1; v <= size; v++)
+  {
+    memberStart[component[v] + 1]++;
+  }
+  for (int c = 0; c < componentCount; c++)
+  {
+    memberStart[c + 1] += memberStart[c];
+  }
+  vector<int> next(memberStart.begin(), memberStart.end() - 1);
+  for (int v = 1; v <= size; v++)
+  {
+    members[next[component[v]]++] = v;
+  }
+
+  dagStart.assign(componentCount + 1, 0); //Condensed graph without duplicates
+  dagEdges.clear();
+  vector<int> seen(componentCount, -1);   //Last component to add an edge to it
+  for (int c = 0; c < componentCount; c++)
+  {
+    dagStart[c] = dagEdges.size();
+    for (int i = memberStart[c]; i < memberStart[c + 1]; i++)
+    {
+      EdgeCursor cursor = edgesOf(members[i]);
+      int w;
+      while (nextEdge(cursor, w))
+      {
+        int d = component[w];
+        if (d != c && seen[d] != c)
+        {
+          seen[d] = c;
+          dagEdges.push_back(d);
+        }
+      }
+    }
+  }
+  dagStart[componentCount] = dagEdges.size();
+
+  closure.clear();
+  low.clear();
+  post.clear();
+  treeLow.clear();
+  hopOutStart.clear();
+  hopOut.clear();
+  hopInStart.clear();
+  hopIn.clear();
+  dagReverseStart.clear();
+  dagReverseEdges.clear();
+  if (componentCount <= CLOSURELIMIT)
+  { //Small enough for a full closure: each row is itself plus the rows of
+    closureWords = (componentCount + 63) / 64; //the components below it
+    closure.assign((size_t)componentCount * closureWords, 0);
+    for (int c = 0; c < componentCount; c++)
+    {
+      unsigned long long *row = &closure[(size_t)c * closureWords];
+      row[c / 64] |= 1ULL << (c % 64);
+      for (int e = dagStart[c]; e < dagStart[c + 1]; e++)
+      {
+        const unsigned long long *below = &closure[(size_t)dagEdges[e] * closureWords];
+        for (int i = 0; i < closureWords; i++)
+        {
+          row[i] |= below[i];
+        }
+      }
+    }
+    dagStart.clear(); //The closure answers every query on its own
+    dagEdges.clear();
+  }
+  else
+  { //Too large: label each component with intervals instead
+    closureWords = 0;
+    low.assign((size_t)componentCount * LABELINGS, -1);
+    post.assign((size_t)componentCount * LABELINGS, -1);
+    treeLow.assign(componentCount, -1);
+    for (int labeling = 0; labeling < LABELINGS; labeling++)
+    {
+      labelTraversal(labeling);
+    }
+    if (buildHopLabels())
+    {
+      dagStart.clear(); //The labels answer every query on their own
+      dagEdges.clear();
+      dagReverseStart.clear();
+      dagReverseEdges.clear();
+    }
+  }
+} //end of buildReachability
+
+//----------------------------buildHopLabels---------------------------------
+//Description: Private helper function to build 2-hop labels by pruned
+//             searches over the condensed graph. Components are taken as hubs
+//             one at a time, busiest first. Each hub searches forward and
+//             backward, adding itself to the label of every component it
+//             reaches that the labels so far cannot already connect to it,
+//             and stopping at those they can. Afterwards c reaches d exactly
+//             when some hub is in both the out-label of c and the in-label
+//             of d. Gives up, leaving no labels, if they would hold more than
+//             HOPBUDGET entries per component on average; the reversed
+//             condensed graph it builds is then kept for searchReachable.
+//---------------------------------------------------------------------------
+bool GraphL::buildHopLabels()
+{
+  dagReverseStart.assign(componentCount + 1, 0); //Condensed graph, reversed
+  dagReverseEdges.assign(dagEdges.size(), 0);
+  for (size_t e = 0; e < dagEdges.size(); e++)
+  {
+    dagReverseStart[dagEdges[e] + 1]++;
+  }
+  for (int c = 0; c < componentCount; c++)
+  {
+    dagReverseStart[c + 1] += dagReverseStart[c];
+  }
+  vector<int> next(dagReverseStart.begin(), dagReverseStart.end() - 1);
+  for (int c = 0; c < componentCount; c++)
+  {
+    for (int e = dagStart[c]; e < dagStart[c + 1]; e++)
+    {
+      dagReverseEdges[next[dagEdges[e]]++] = c;
+    }
+  }
+
+  vector<pair<long long, int> > busiest(componentCount); //Hub order
+  for (int c = 0; c < componentCount; c++)
+  {
+    long long degree = (long long)(dagStart[c + 1] - dagStart[c] + 1)
+                     * (dagReverseStart[c + 1] - dagReverseStart[c] + 1);
+    busiest[c] = make_pair(-degree, c);
+  }
+  sort(busiest.begin(), busiest.end());
+
+  vector<vector<int> > out(componentCount); //Hub ranks, so each stays sorted
+  vector<vector<int> > in(componentCount);
+  vector<int> seen(componentCount, -1);     //Last search to reach it
+  vector<int> queue;
+  long long entries = 0;
+  long long budget = (long long)HOPBUDGET * componentCount;
+  for (int rank = 0; rank < componentCount; rank++)
+  {
+    int hub = busiest[rank].second;
+    for (int direction = 0; direction < 2; direction++)
+    { //Forward fills in-labels, backward fills out-labels
+      int search = rank * 2 + direction;
+      const vector<int> &start = direction == 0 ? dagStart : dagReverseStart;
+      const vector<int> &edges = direction == 0 ? dagEdges : dagReverseEdges;
+      queue.assign(1, hub);
+      seen[hub] = search;
+      for (size_t q = 0; q < queue.size(); q++)
+      {
+        int c = queue[q];
+        const vector<int> &from = direction == 0 ? out[hub] : out[c];
+        const vector<int> &to = direction == 0 ? in[c] : in[hub];
+        size_t i = 0, j = 0;
+        bool connected = false;
+        while (!connected && i < from.size() && j < to.size())
+        { //Sorted merge, looking for a shared hub
+          if (from[i] == to[j])
+          {
+            connected = true;
+          }
+          else if (from[i] < to[j])
+          {
+            i++;
+          }
+          else
+          {
+            j++;
+          }
+        }
+        if (connected)
+        {
+          continue; //Already covered by an earlier hub
+        }
+        (direction == 0 ? in[c] : out[c]).push_back(rank);
+        if (++entries > budget)
+        {
+          return false;
+        }
+        for (int e = start[c]; e < start[c + 1]; e++)
+        {
+          if (seen[edges[e]] != search)
+          {
+            seen[edges[e]] = search;
+            queue.push_back(edges[e]);
+          }
+        }
+      }
+    }
+  }
+
+  hopOutStart.assign(componentCount + 1, 0); //Pack the labels together
+  hopInStart.assign(componentCount + 1, 0);
+  hopOut.clear();
+  hopIn.clear();
+  for (int c = 0; c < componentCount; c++)
+  {
+    hopOut.insert(hopOut.end(), out[c].begin(), out[c].end());
+    hopIn.insert(hopIn.end(), in[c].begin(), in[c].end());
+    hopOutStart[c + 1] = hopOut.size();
+    hopInStart[c + 1] = hopIn.size();
+  }
+  return true;
+} //end of buildHopLabels
+
+//-----------------------------hopReachable----------------------------------
+//Description: Private helper function to check, with the 2-hop labels,
+//             whether one component reaches another: it does exactly when
+//             some hub is in both the out-label of one and the in-label of
+//             the other.
+//---------------------------------------------------------------------------
+bool GraphL::hopReachable(const int from, const int to) const
+{
+  int i = hopOutStart[from], iEnd = hopOutStart[from + 1];
+  int j = hopInStart[to], jEnd = hopInStart[to + 1];
+  while (i < iEnd && j < jEnd)
+  {
+    if (hopOut[i] == hopIn[j])
+    {
+      return true;
+    }
+    else if (hopOut[i] < hopIn[j])
+    {
+      i++;
+    }
+    else
+    {
+      j++;
+    }
+  }
+  return false;
+} //end of hopReachable
+
+//----------------------------labelTraversal---------------------------------
+//Description: Private helper function to give every component one interval
+//             label from a post-order traversal of the condensed graph:
+//             [lowest post-order number below it, its own number]. If c
+//             reaches d, the label of d lies inside the label of c, so a
+//             pair whose labels do not nest is unreachable. The first traversal
+//             starts from the highest (source-most) components and follows
+//             edges in order; each later one uses a different start order
+//             and rotates every component's edges, so its labels rule out
+//             pairs the others miss. The first traversal also records where
+//             each component's traversal tree starts, since everything in
+//             that tree is known to be reachable.
+//---------------------------------------------------------------------------
+void GraphL::labelTraversal(const int labeling)
+{
+  vector<int> roots(componentCount);
+  for (int c = 0; c < componentCount; c++)
+  {
+    roots[c] = componentCount - 1 - c;
+  }
+  unsigned seed = 2654435761u * (labeling + 1); //Scrambles the later orders
+  if (labeling > 0)
+  {
+    for (int c = componentCount - 1; c > 0; c--)
+    { //Shuffle the start order
+      seed = seed * 1103515245u + 12345u;
+      swap(roots[c], roots[(seed >> 8) % (c + 1)]);
+    }
+  }
+  vector<pair<int, int> > dagStack; //Component, and edges followed so far
+  int number = 0;
+  for (int r = 0; r < componentCount; r++)
+  {
+    int s = roots[r];
+    if (low[(size_t)s * LABELINGS + labeling] != -1)
+    {
+      continue; //Already labeled in this traversal
+    }
+    low[(size_t)s * LABELINGS + labeling] = numeric_limits<int>::max(); //Started
+    if (labeling == 0)
+    {
+      treeLow[s] = number;
+    }
+    dagStack.push_back(make_pair(s, 0));
+    while (!dagStack.empty())
+    {
+      int c = dagStack.back().first;
+      int degree = dagStart[c + 1] - dagStart[c];
+      int followed = dagStack.back().second;
+      if (followed < degree)
+      { //Follow the next edge, starting at a different edge per labeling
+        dagStack.back().second++;
+        int rotate = (labeling == 0) ? 0 : (int)(((unsigned)c * seed >> 8) % degree);
+        int d = dagEdges[dagStart[c] + (followed + rotate) % degree];
+        if (low[(size_t)d * LABELINGS + labeling] == -1)
+        {
+          low[(size_t)d * LABELINGS + labeling] = numeric_limits<int>::max();
+          if (labeling == 0)
+          {
+            treeLow[d] = number;
+          }
+          dagStack.push_back(make_pair(d, 0));
+        }
+      }
+      else
+      { //Finished: number it, and take the lowest label below it
+        dagStack.pop_back();
+        size_t label = (size_t)c * LABELINGS + labeling;
+        post[label] = number++;
+        low[label] = min(low[label], post[label]);
+        for (int i = dagStart[c]; i < dagStart[c + 1]; i++)
+        {
+          low[label] = min(low[label], low[(size_t)dagEdges[i] * LABELINGS + labeling]);
+        }
+      }
+    }
+  }
+} //end of labelTraversal
+
+//--------------------------intervalContains---------------------------------
+//Description: Private helper function to check whether every interval label
+//             of one component lies inside the matching label of another. If
+//             any does not, the outer component cannot reach the inner one.
+//---------------------------------------------------------------------------
+bool GraphL::intervalContains(const int outer, const int inner) const
+{
+  const int *outerLow = &low[(size_t)outer * LABELINGS];
+  const int *outerPost = &post[(size_t)outer * LABELINGS];
+  const int *innerLow = &low[(size_t)inner * LABELINGS];
+  const int *innerPost = &post[(size_t)inner * LABELINGS];
+  for (int i = 0; i < LABELINGS; i++)
+  {
+    if (innerLow[i] < outerLow[i] || innerPost[i] > outerPost[i])
+    {
+      return false;
+    }
+  }
+  return true;
+} //end of intervalContains
+
+//-----------------------------treeContains----------------------------------
+//Description: Private helper function to check whether one component is in
+//             the first traversal tree of another. If it is, the outer
+//             component reaches the inner one.
+//---------------------------------------------------------------------------
+bool GraphL::treeContains(const int outer, const int inner) const
+{
+  int innerPost = post[(size_t)inner * LABELINGS];
+  return treeLow[outer] <= innerPost && innerPost <= post[(size_t)outer * LABELINGS];
+} //end of treeContains
+
 //--------------------------depthFirstSearch---------------------------------
 //Description: Public function to execute a search on a graph using the
 //             depth-first search algorithm to traverse each node in the graph
-//             in order. Outputs the results of traversal. Calls the dfsHelper
-//             private recursive helper function.
+//             in order. Outputs the results of traversal to the stream (the
+//             console by default). Calls the dfsHelper private helper
+//             function.
 //---------------------------------------------------------------------------
-bool GraphL::depthFirstSearch() const
+bool GraphL::depthFirstSearch(ostream &out) const
 {
   if (this->size == 0) //If the graph is empty, do nothing
   {
@@ -137,61 +637,276 @@ bool GraphL::depthFirstSearch() const
     {                                     //unvisited
       nodes[i].visited = false;
     }
-    cout << "Depth-first ordering: "; //Format to indicate the order of traversal
+    out << "Depth-first ordering: "; //Format to indicate the order of traversal
     for (int v = 1; v <= size; v++) //Loop over each node, check if it's been
     {                               //visited, and if not, call the helper
       if (!(nodes[v].visited))
       {
-        dfsHelper(v);
+        dfsHelper(v, out);
       }
     }
   }
-  cout << endl << endl; //Double new line to stay consistent with required format
+  out << endl << endl; //Double new line to stay consistent with required format
   return true;
 } //end of depthFirstSearch
 
 //------------------------------dfsHelper------------------------------------
-//Description: Private recursive helper function for depthFirstSearch. Outputs
+//Description: Private helper function for depthFirstSearch. Outputs
 //             results of traversal according to required formatting. Parameter
-//             received is that of an unvisited node.
+//             received is that of an unvisited node. Keeps its own stack of
+//             edge cursors, one per node on the current path, rather than
+//             recursing, since large graphs can be far deeper than the call
+//             stack allows; nodes are printed in the same order recursion
+//             would print them.
 //---------------------------------------------------------------------------
-void GraphL::dfsHelper(const int v) const
+void GraphL::dfsHelper(const int v, ostream &out) const
 {
-  nodes[v].visited = true; //Mark the node as visited, and print the node
-  cout << v << " ";
-  EdgeNode *current = nodes[v].edgeHead; //Establish a current to traverse list
-  while (current != nullptr)
+  vector<EdgeCursor> stack; //Next edge to follow of each node on the path
+  nodes[v].visited = true;  //Mark the node as visited, and print the node
+  out << v << " ";
+  stack.push_back(edgesOf(v));
+  while (!stack.empty())
   {
-    if (!(nodes[current->adjGraphNode].visited)) //If the adjacent node has not
-    {                                            //been visited, keep traversing
-      dfsHelper(current->adjGraphNode);
+    int w;
+    if (!nextEdge(stack.back(), w))
+    {
+      stack.pop_back(); //Every edge of this node followed
+    }
+    else if (!(nodes[w].visited)) //If the adjacent node has not been
+    {                             //visited, keep traversing from it
+      nodes[w].visited = true;
+      out << w << " ";
+      stack.push_back(edgesOf(w));
     }
-    current = current->nextEdge;
   }
 } //end of dfsHelper
 
 //----------------------------displayGraph-----------------------------------
 //Description: Public function to display the contents of the graph in required
-//             format.
+//             format, to the stream (the console by default).
 //---------------------------------------------------------------------------
-void GraphL::displayGraph() const
+void GraphL::displayGraph(ostream &out) const
 {
   if (this->size > 0) //Only display if the graph is not empty
   {
-    cout << "Graph:" << endl; //Header
+    out << "Graph:" << endl; //Header
     for (int i = 1; i <= this->size; i++)
     { //Loop over each nodes and format header for the node and print its value
-      cout << "Node" << i << "         " << *nodes[i].data << endl;
+      out << "Node" << i << "         " << *nodes[i].data << endl;
+      if (compressed)
+      { //Decode and print each adjacent node
+        CompressedAdjacency::Cursor cursor = compressedEdges.neighbors(i);
+        int w, weight;
+        while (cursor.next(w, weight))
+        {
+          out << "  edge  " << i << "  " << w << endl;
+        }
+      }
       if (nodes[i].edgeHead != nullptr)
       { //If there is adjacent and connected node, continue with traversing list
         EdgeNode *current = nodes[i].edgeHead;
         while (current != nullptr)
         { //Print the value of the adjacent node and continue through the list
-          cout << "  edge  " << i << "  " << current->adjGraphNode << endl;
+          out << "  edge  " << i << "  " << current->adjGraphNode << endl;
           current = current->nextEdge;
         }
       }
     }
   }
-  cout << endl; //New line to stay consistent with output format
+  out << endl; //New line to stay consistent with output format
 } //end of displayGraph
+
+//------------------------------reachable------------------------------------
+//Description: Public function to check whether there is a path from one node
+//             to another, using the index built by buildGraph. Nodes in the
+//             same component always reach each other. On graphs indexed with
+//             a closure, this is one bit lookup. On larger graphs, the
+//             interval labels rule out most unreachable pairs at once, and
+//             the first traversal tree confirms many reachable ones, and
+//             2-hop labels settle the rest with one merge of two short lists.
+//             Only on graphs whose 2-hop labels would not fit in HOPBUDGET
+//             (dense graphs where most components reach a large share of the
+//             rest) is the rest settled by searchReachable instead. That is
+//             not constant time: it costs time in proportion to the
+//             components it visits between the two nodes, which on such
+//             graphs is typically tens to hundreds per query.
+//---------------------------------------------------------------------------
+bool GraphL::reachable(const int fromNode, const int toNode) const
+{
+  if (fromNode < 1 || toNode < 1 || fromNode > size || toNode > size)
+  {
+    return false; //Not on the graph
+  }
+  int from = component[fromNode];
+  int to = component[toNode];
+  if (from == to)
+  {
+    return true;
+  }
+  if (to > from)
+  {
+    return false; //Edges only lead to lower components
+  }
+  if (closureWords > 0)
+  {
+    return (closure[(size_t)from * closureWords + to / 64] >> (to % 64)) & 1ULL;
+  }
+  if (treeContains(from, to))
+  {
+    return true;
+  }
+  if (!intervalContains(from, to))
+  {
+    return false;
+  }
+  if (!hopOutStart.empty())
+  {
+    return hopReachable(from, to);
+  }
+  return searchReachable(from, to);
+} //end of reachable
+
+//---------------------------searchReachable---------------------------------
+//Description: Private helper function for reachable on graphs with neither a
+//             closure nor 2-hop labels. Searches the condensed graph forward
+//             from one component and backward from the other at once,
+//             always growing the smaller frontier, until the two searches
+//             meet, a traversal tree proves the path, or either side runs
+//             out. Neither side enters a component the interval labels rule
+//             out. Components are marked with the number of the search that
+//             reached them, in arrays kept per thread, so a call neither
+//             clears nor allocates anything the size of the graph; each
+//             thread keeps two ints per component of the largest graph it
+//             has searched.
+//---------------------------------------------------------------------------
+bool GraphL::searchReachable(const int from, const int to) const
+{
+  static thread_local vector<unsigned> forwardMark;  //Search that last reached
+  static thread_local vector<unsigned> backwardMark; //each component
+  static thread_local unsigned search = 0;
+  if (forwardMark.size() < (size_t)componentCount)
+  {
+    forwardMark.resize(componentCount, 0);
+    backwardMark.resize(componentCount, 0);
+  }
+  if (++search == 0)
+  { //Search numbers ran out, so start again from clean marks
+    fill(forwardMark.begin(), forwardMark.end(), 0);
+    fill(backwardMark.begin(), backwardMark.end(), 0);
+    search = 1;
+  }
+  vector<int> forward(1, from); //Components from reaches, in search order
+  vector<int> backward(1, to);  //Components that reach to, in search order
+  size_t f = 0, b = 0;          //Next of each to expand
+  forwardMark[from] = search;
+  backwardMark[to] = search;
+  while (f < forward.size() && b < backward.size())
+  {
+    if (forward.size() - f <= backward.size() - b)
+    { //Follow the edges out of the next component from reaches
+      int c = forward[f++];
+      for (int e = dagStart[c]; e < dagStart[c + 1]; e++)
+      {
+        int d = dagEdges[e];
+        if (backwardMark[d] == search || treeContains(d, to))
+        {
+          return true; //d reaches to
+        }
+        if (forwardMark[d] != search && d > to && intervalContains(d, to))
+        { //Only follow components that could still lead to the target
+          forwardMark[d] = search;
+          forward.push_back(d);
+        }
+      }
+    }
+    else
+    { //Follow the edges into the next component that reaches to
+      int c = backward[b++];
+      for (int e = dagReverseStart[c]; e < dagReverseStart[c + 1]; e++)
+      {
+        int d = dagReverseEdges[e];
+        if (forwardMark[d] == search || treeContains(from, d))
+        {
+          return true; //from reaches d
+        }
+        if (backwardMark[d] != search && d < from && intervalContains(from, d))
+        { //Only follow components the source could still reach
+          backwardMark[d] = search;
+          backward.push_back(d);
+        }
+      }
+    }
+  }
+  return false; //One side ran out without meeting the other
+} //end of searchReachable
+
+//-----------------------------getIndexSize----------------------------------
+//Description: Public function to return the size, in bytes, of the
+//             reachability index built by buildGraph.
+//---------------------------------------------------------------------------
+long GraphL::getIndexSize() const
+{
+  return component.size() * sizeof(int) + closure.size() * sizeof(unsigned long long)
+       + (dagStart.size() + dagEdges.size() + dagReverseStart.size() + dagReverseEdges.size()
+          + low.size() + post.size() + treeLow.size() + hopOutStart.size() + hopOut.size()
+          + hopInStart.size() + hopIn.size()) * sizeof(int);
+} //end of getIndexSize
+
+//-------------------------------getSize-------------------------------------
+//Description: Public function to return the number of nodes on the graph.
+//---------------------------------------------------------------------------
+int GraphL::getSize() const
+{
+  return this->size;
+} //end of getSize
+
+//-------------------------------compress------------------------------------
+//Description: Public function to move every edge out of the linked lists
+//             and into a CompressedAdjacency, freeing the EdgeNodes. Each
+//             node's edges are then kept sorted, so depthFirstSearch and
+//             displayGraph visit them in increasing order. The reachability
+//             index is unaffected. This shrinks the finished graph only: the
+//             lists were already built, and both exist while it runs, so use
+//             buildGraph with compressed true where memory while building is
+//             the limit. Returns false if the graph is empty or already
+//             compressed.
+//---------------------------------------------------------------------------
+bool GraphL::compress()
+{
+  if (this->size == 0 || compressed)
+  {
+    return false;
+  }
+  compressedEdges.clear(false);
+  listBytes = 0;
+  vector<pair<int, int> > edges; //Edges of one node, reused for each
+  for (int i = 1; i <= this->size; i++)
+  {
+    edges.clear();
+    while (nodes[i].edgeHead != nullptr)
+    { //Take each edge from the list, and free it
+      EdgeNode *temp = nodes[i].edgeHead;
+      edges.push_back(make_pair(temp->adjGraphNode, 1));
+      nodes[i].edgeHead = temp->nextEdge;
+      delete temp;
+      listBytes += sizeof(EdgeNode);
+    }
+    compressedEdges.addNode(edges);
+  }
+  compressed = true;
+  return true;
+} //end of compress
+
+//--------------------------getCompressionRatio------------------------------
+//Description: Public function to return how many times smaller the edges
+//             are after compress than they were as linked lists, counting
+//             the offsets of each list. Returns 1 if not compressed.
+//---------------------------------------------------------------------------
+double GraphL::getCompressionRatio() const
+{
+  if (!compressed || compressedEdges.getBytes() == 0)
+  {
+    return 1.0;
+  }
+  return (double)listBytes / compressedEdges.getBytes();
+} //end of getCompressionRatio
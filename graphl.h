@@ -12,6 +12,14 @@
 //Notes: Assumption: NodeData (container for strings of names of locations)
 //       provides proper data checking and overloads appropriate operators
 //       for comparison, and the file being provided is formatted correctly.
+//       buildGraph also builds a reachability index so reachable can answer
+//       connectivity questions without a full depth-first search.
+//       After compress, or buildGraph with compressed true, edges are kept
+//       in a CompressedAdjacency instead of linked lists, and each node's
+//       edges are visited in increasing order rather than the reverse of the
+//       file's order. compress only shrinks the finished graph, since the
+//       lists are built first; buildGraph with compressed true never builds
+//       them, so it also lowers the memory needed while building.
 //---------------------------------------------------------------------------
 
 #ifndef GRAPHL_H
@@ -19,9 +27,15 @@
 #include <iostream>
 #include <fstream>
 #include <limits>
+#include <vector>
+#include "compressedadjacency.h"
 #include "nodedata.h"
 using namespace std;
 
+const int CLOSURELIMIT = 8192; //Most components indexed by a full closure
+const int LABELINGS = 5;       //Interval labels per component above that
+const int HOPBUDGET = 64;      //Most 2-hop label entries per component, on average
+
 class GraphL
 {
 public:
@@ -29,10 +43,15 @@ public:
   GraphL();
   ~GraphL();
   //Getters
-  void displayGraph() const;
+  void displayGraph(ostream &out = cout) const;
+  bool reachable(const int fromNode, const int toNode) const;
+  long getIndexSize() const;
+  int getSize() const;
+  double getCompressionRatio() const;
   //Setters
-  bool depthFirstSearch() const;
-  bool buildGraph(ifstream &inFile);
+  bool depthFirstSearch(ostream &out = cout) const;
+  bool buildGraph(ifstream &inFile, const bool compressed = false);
+  bool compress();
 private:
   struct EdgeNode
   {
@@ -45,10 +64,45 @@ private:
     NodeData* data;     //Data information about each node
     bool visited;
   };
+  struct EdgeCursor
+  {
+    EdgeNode *edge;                   //Next edge, if not compressed
+    CompressedAdjacency::Cursor list; //Next edge, if compressed
+  };
   GraphNode *nodes;
   int size;
+  bool compressed;             //Whether edges are in compressedEdges
+  CompressedAdjacency compressedEdges; //Edges of every node, after compress
+  long listBytes;              //Memory the linked lists used, for the ratio
+  //Reachability index, built once by buildGraph
+  vector<int> component;       //Strongly connected component of each node
+  int componentCount;          //Components, numbered in reverse topological order
+  int closureWords;            //64-bit words in each row of closure
+  vector<unsigned long long> closure; //Bit rows of components each one reaches
+  vector<int> dagStart;        //Condensed graph, for graphs over CLOSURELIMIT
+  vector<int> dagEdges;        //components (edges of c at dagStart[c]..[c+1])
+  vector<int> dagReverseStart; //The same graph reversed, kept only when there
+  vector<int> dagReverseEdges; //are no 2-hop labels, for searchReachable
+  vector<int> low;             //Interval labels, LABELINGS per component:
+  vector<int> post;            //lowest post-order number below it, and its own
+  vector<int> treeLow;         //First post-order number in its first traversal
+                               //tree; the tree holds treeLow..post exactly
+  vector<int> hopOutStart;     //2-hop labels, if they fit in HOPBUDGET: hubs
+  vector<int> hopOut;          //each component reaches, and hubs that reach
+  vector<int> hopInStart;      //it, both sorted; c reaches d exactly when
+  vector<int> hopIn;           //the hubs out of c and into d share one
   //Utility and Helper Functions
   bool insertEdge(const int fromNode, const int toNode);
-  void dfsHelper(const int v) const;
+  void encodeEdges(vector<pair<int, int> > &edges);
+  EdgeCursor edgesOf(const int v) const;
+  bool nextEdge(EdgeCursor &cursor, int &w) const;
+  void dfsHelper(const int v, ostream &out) const;
+  void buildReachability();
+  void labelTraversal(const int labeling);
+  bool buildHopLabels();
+  bool hopReachable(const int from, const int to) const;
+  bool searchReachable(const int from, const int to) const;
+  bool intervalContains(const int outer, const int inner) const;
+  bool treeContains(const int outer, const int inner) const;
 };
 #endif
@@ -15,6 +15,7 @@
 //       for comparison, and the file being provided is formatted correctly.
 //---------------------------------------------------------------------------
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include "graphm.h"
@@ -40,20 +41,47 @@ GraphM::~GraphM()
 } //end of ~GraphM
 
 //-----------------------------initializeC-----------------------------------
-//Description: A utility function to initialize the C (adjacency matrix)
-//             2D array's elements to the maximum integer (infinity).
+//Description: A utility function to publish the first version of the C
+//             (adjacency matrix) with every element set to the maximum
+//             integer (infinity). All rows share one empty row until an
+//             update copies them.
 //---------------------------------------------------------------------------
 void GraphM::initializeC()
 {
+  shared_ptr<CostRow> empty = make_shared<CostRow>();
+  for (int j = 0; j < MAXNODES; j++)
+  {
+    empty->cost[j] = INFINITY; //Set every collumn in the row to infinity
+  }
+  shared_ptr<Snapshot> first = make_shared<Snapshot>();
+  first->version = 0;
   for (int i = 0; i < MAXNODES; i++)
   {
-    for (int j = 0; j < MAXNODES; j++)
-    {
-      C[i][j] = INFINITY; //Go through each row and collumn and set the values
-    }                     //in the matrix to infinity
+    first->C[i] = empty; //Point each row of the matrix at the empty row
   }
+  atomic_store(&current, shared_ptr<const Snapshot>(first));
 } //end of initializeC
 
+//-----------------------------pinSnapshot-----------------------------------
+//Description: A utility function to take a reference to the latest published
+//             version of the adjacency matrix. The version stays alive and
+//             unchanged for as long as the caller holds it, no matter how
+//             many updates are published in the meantime.
+//---------------------------------------------------------------------------
+shared_ptr<const GraphM::Snapshot> GraphM::pinSnapshot() const
+{
+  return atomic_load(&current);
+} //end of pinSnapshot
+
+//------------------------------validEdge------------------------------------
+//Description: A utility function to check that both nodes are on the graph
+//             and that the weight is not negative.
+//---------------------------------------------------------------------------
+bool GraphM::validEdge(const int fromNode, const int toNode, const int weight) const
+{
+  return (fromNode >= 1) && (toNode >= 1) && (fromNode <= size) && (toNode <= size) && (weight >= 0);
+} //end of validEdge
+
 //-----------------------------initializeT-----------------------------------
 //Description: A utility function to initialize the T 2D array's data members
 //             to their defaults: Univisted nodes, distance of the maximum
@@ -104,6 +132,7 @@ bool GraphM::buildGraph(ifstream &inFile)
     {
       data[i].setData(inFile);
     }
+    vector<EdgeUpdate> edges; //Edges read so far, published as one version
     for (;;) //Loop until broken
     {
       inFile >> fromNode >> toNode >> weight; //Assign each variable
@@ -115,8 +144,13 @@ bool GraphM::buildGraph(ifstream &inFile)
       {
         break;
       }
-      insertEdge(fromNode, toNode, weight); //Otherwise, insert the variables into
-    }                                       //the graph
+      if (validEdge(fromNode, toNode, weight)) //Otherwise, keep the edge for
+      {                                        //the graph
+        EdgeUpdate edge = {fromNode, toNode, weight};
+        edges.push_back(edge);
+      }
+    }
+    applyUpdates(edges); //Publish all of the edges at once
   }
   return true;
 } //end of buildGraph
@@ -127,12 +161,8 @@ bool GraphM::buildGraph(ifstream &inFile)
 //---------------------------------------------------------------------------
 bool GraphM::insertEdge(const int fromNode, const int toNode, const int weight)
 {
-  if ((fromNode >= 1) && (toNode >= 1) && (fromNode <= size) && (toNode <= size) && (weight >= 0) && weight <= INFINITY)
-  { //If the nodes and weight are within range, insert it into the adjacency matrix
-    C[fromNode][toNode] = weight;
-    return true;
-  }
-  return false;
+  EdgeUpdate edge = {fromNode, toNode, weight}; //Publish as a batch of one
+  return applyUpdates(vector<EdgeUpdate>(1, edge));
 } //end of insertEdge
 
 //------------------------------removeEdge-----------------------------------
@@ -140,14 +170,46 @@ bool GraphM::insertEdge(const int fromNode, const int toNode, const int weight)
 //             starting node and an ending node.
 //---------------------------------------------------------------------------
 bool GraphM::removeEdge(const int fromNode, const int toNode)
+{ //Remove by resetting it to infinity
+  EdgeUpdate edge = {fromNode, toNode, INFINITY};
+  return applyUpdates(vector<EdgeUpdate>(1, edge));
+} //end of removeEdge
+
+//-----------------------------applyUpdates----------------------------------
+//Description: Public function to apply a batch of edge changes and publish
+//             them as a single new version of the adjacency matrix. Only the
+//             rows that change are copied; all others are shared with the
+//             previous version. Readers holding an older version keep seeing
+//             it unchanged. If any edge in the batch is out of range nothing
+//             is published.
+//---------------------------------------------------------------------------
+bool GraphM::applyUpdates(const vector<EdgeUpdate> &updates)
 {
-  if (fromNode > 0 || toNode <= this->size)
-  { //If the nodes are in range, remove by resetting it to infinity
-    C[fromNode][toNode] = INFINITY;
-    return true;
+  for (size_t i = 0; i < updates.size(); i++) //Check the whole batch first
+  {
+    if (!validEdge(updates[i].fromNode, updates[i].toNode, updates[i].weight))
+    {
+      return false;
+    }
   }
-  return false; //Otherwise, do nothing
-} //end of removeEdge
+  lock_guard<mutex> guard(writeLock); //One writer at a time
+  shared_ptr<const Snapshot> previous = pinSnapshot();
+  shared_ptr<Snapshot> next = make_shared<Snapshot>(*previous);
+  shared_ptr<CostRow> copied[MAXNODES]; //Rows already copied in this batch
+  for (size_t i = 0; i < updates.size(); i++)
+  {
+    int row = updates[i].fromNode;
+    if (copied[row] == nullptr)
+    { //Copy the row the first time the batch touches it
+      copied[row] = make_shared<CostRow>(*previous->C[row]);
+      next->C[row] = copied[row];
+    }
+    copied[row]->cost[updates[i].toNode] = updates[i].weight;
+  }
+  next->version = previous->version + 1;
+  atomic_store(&current, shared_ptr<const Snapshot>(next)); //Publish
+  return true;
+} //end of applyUpdates
 
 //---------------------------findShortestPath--------------------------------
 //Description: Uses Dijkstra's shortest path algorithm to the shortest path
@@ -160,19 +222,26 @@ void GraphM::findShortestPath()
 {
   int v = 0; //Variable for the adjacent node (index) with smallest weight
   int w = 0; //Variable for the current adjacent node (index) to compare distances from v
+  shared_ptr<const Snapshot> snapshot = pinSnapshot(); //Use one version throughout
+  initializeT(false); //Forget paths found on any earlier version
   for (int source = 1; source <= this->size; source++)
   { //Loop over each node, starting at the beginning
     T[source][source].dist = 0; //Set the initial distance to 0
     for (int i = 1; i <= this->size; i++)
     { //Nested loop to run over adjacent nodes from the starting node to locate smallest weight
       v = findMinimum(T[source]); //Find the adjacent node with the smallest weight
+      if (v == 0)
+      {
+        break; //Every remaining node is unreachable
+      }
       T[source][v].visited = true; //Mark the node as visited
+      const int *C = snapshot->C[v]->cost; //Costs from v
       for (int j = 1; j <= this->size; j++)
       { //Nested loop to compare the shortest distance node with that of adjcent unvisited nodes
         w = j; //Assign index for adjacent node to loop index
-        if (!(T[source][w].visited) && (C[v][w] != INFINITY) && ((T[source][v].dist + C[v][w]) < T[source][w].dist))
+        if (!(T[source][w].visited) && (C[w] != INFINITY) && ((T[source][v].dist + C[w]) < T[source][w].dist))
         { //If the node is unvisited, the weight is present, and it's less than the current distance
-          T[source][w].dist = (T[source][v].dist + C[v][w]); //Establish the distance
+          T[source][w].dist = (T[source][v].dist + C[w]); //Establish the distance
           T[source][w].path = v; //Establish the path
         }
       }
@@ -181,6 +250,90 @@ void GraphM::findShortestPath()
   }
 } //end of findShortestPath
 
+//---------------------------shortestDistance--------------------------------
+//Description: Public function to find the shortest distance between two
+//             nodes on the latest published version of the graph. Safe to
+//             call while updates are being applied (see shortestPath).
+//             Returns INFINITY if there is no path.
+//---------------------------------------------------------------------------
+int GraphM::shortestDistance(const int fromNode, const int toNode) const
+{
+  vector<int> path;
+  return shortestPath(fromNode, toNode, path);
+} //end of shortestDistance
+
+//-----------------------------shortestPath----------------------------------
+//Description: Public function to find the shortest path between two nodes
+//             with Dijkstra's algorithm, on the latest published version of
+//             the graph. Keeps its table locally rather than in T, so many
+//             threads may call it while updates are being applied; the
+//             distance and the path both come from the one version it pins.
+//             Fills path with the nodes from fromNode to toNode and returns
+//             the distance, or leaves path empty and returns INFINITY if
+//             there is no path.
+//---------------------------------------------------------------------------
+int GraphM::shortestPath(const int fromNode, const int toNode, vector<int> &path) const
+{
+  path.clear();
+  if (!validEdge(fromNode, toNode, 0))
+  {
+    return INFINITY;
+  }
+  shared_ptr<const Snapshot> snapshot = pinSnapshot(); //Pin one version
+  TableType table[MAXNODES];
+  for (int i = 0; i < MAXNODES; i++)
+  {
+    table[i].visited = false;
+    table[i].dist = INFINITY;
+    table[i].path = 0;
+  }
+  table[fromNode].dist = 0;
+  for (int i = 1; i <= this->size; i++)
+  {
+    int v = findMinimum(table); //Closest unvisited node
+    if (v == 0 || v == toNode)
+    {
+      break; //Either unreachable, or the distance is final
+    }
+    table[v].visited = true;
+    const int *C = snapshot->C[v]->cost; //Costs from v
+    for (int w = 1; w <= this->size; w++)
+    {
+      if (!(table[w].visited) && (C[w] != INFINITY) && ((table[v].dist + C[w]) < table[w].dist))
+      {
+        table[w].dist = (table[v].dist + C[w]);
+        table[w].path = v;
+      }
+    }
+  }
+  if (table[toNode].dist != INFINITY)
+  { //Trace the path back from toNode, then put it in order
+    for (int v = toNode; v != 0; v = table[v].path)
+    {
+      path.push_back(v);
+    }
+    reverse(path.begin(), path.end());
+  }
+  return table[toNode].dist;
+} //end of shortestPath
+
+//------------------------------getVersion-----------------------------------
+//Description: Public function to return the version number of the latest
+//             published adjacency matrix. Increases by one per update batch.
+//---------------------------------------------------------------------------
+long GraphM::getVersion() const
+{
+  return pinSnapshot()->version;
+} //end of getVersion
+
+//-------------------------------getSize-------------------------------------
+//Description: Public function to return the number of nodes on the graph.
+//---------------------------------------------------------------------------
+int GraphM::getSize() const
+{
+  return this->size;
+} //end of getSize
+
 //------------------------------findMinimum----------------------------------
 //Description: Private helper function to locate the node being passed in
 //             (the adjacent nodes) that is smallest and return the node (index)
@@ -189,7 +342,7 @@ void GraphM::findShortestPath()
 int GraphM::findMinimum(const TableType node[]) const
 {
   int min = INFINITY; //Assign the lowest value so far to infinity
-  int minIndex;
+  int minIndex = 0;   //0 if every unvisited node is unreachable
   for (int v = 1; v <= this->size; v++) //Go over each adjacent node
   {
     if (!(node[v].visited) && (node[v].dist < min))
@@ -203,33 +356,34 @@ int GraphM::findMinimum(const TableType node[]) const
 
 //-------------------------------displayAll----------------------------------
 //Description: A public function to output all data from the graph. First
-//             outputting a header display to the console, followed by
-//             the current node, then by the data in the TableType array;
-//             the distance, then the path. Calls the printPath helper function.
+//             outputting a header display to the stream (the console by
+//             default), followed by the current node, then by the data in
+//             the TableType array; the distance, then the path. Calls the
+//             printPath helper function.
 //             Assumption: findShortestPath function has already been run prior
 //             to this function.
 //---------------------------------------------------------------------------
-void GraphM::displayAll() const
+void GraphM::displayAll(ostream &out) const
 { //Format the header
-  cout << "Description         From Node   To Node   Dijkstra's      Path" << endl;
+  out << "Description         From Node   To Node   Dijkstra's      Path" << endl;
   for (int i = 1; i <= this->size; i++)
   { //Print out the data (locations) from the array
-    cout << data[i] << endl;
+    out << data[i] << endl;
     for (int j = 1; j <= this->size; j++)
     {
       if (i != j) //Do not print a node going to itself
       { //Format the toNode and fromNode
-        cout << "                        " << i << "         " << j << "         ";
+        out << "                        " << i << "         " << j << "         ";
         if (T[i][j].dist != INFINITY && T[i][j].dist > 0)
         { //If there is a distance, print it
-          cout << T[i][j].dist << "            ";
-          printPath(i, j, false); //And print the path
+          out << T[i][j].dist << "            ";
+          printPath(i, j, false, out); //And print the path
         }
         else
         {
-          cout << "----"; //Otherwise, print dashes to represent no distance/path
+          out << "----"; //Otherwise, print dashes to represent no distance/path
         }
-        cout << endl; //Formatting a line break
+        out << endl; //Formatting a line break
       }
     }
   }
@@ -238,26 +392,27 @@ void GraphM::displayAll() const
 //-------------------------------display-------------------------------------
 //Description: Public function to output a specific path from one node to
 //             another on the graph. Starts by outputting the nodes to the
-//             console, then their path if it exists, then the locations
-//             associated with the nodes/path. Calls the printPath helper.
+//             stream (the console by default), then their path if it
+//             exists, then the locations associated with the nodes/path.
+//             Calls the printPath helper.
 //             Assumption: findShortestPath function has already been run prior
 //             to this function.
 //---------------------------------------------------------------------------
-void GraphM::display(const int fromNode, const int toNode) const
+void GraphM::display(const int fromNode, const int toNode, ostream &out) const
 {
   if (fromNode > 0)
   {
-    cout << "   " << fromNode << "         " << toNode << "         ";
+    out << "   " << fromNode << "         " << toNode << "         ";
     if (T[fromNode][toNode].dist != INFINITY) //If a path exists
     {
-      cout << T[fromNode][toNode].dist << "         ";
-      printPath(fromNode, toNode, false); //Print the paths
-      printPath(fromNode, toNode, true); //Print the data
-      cout << data[toNode] << endl << endl; //Print the last data member
+      out << T[fromNode][toNode].dist << "         ";
+      printPath(fromNode, toNode, false, out); //Print the paths
+      printPath(fromNode, toNode, true, out); //Print the data
+      out << data[toNode] << endl << endl; //Print the last data member
     }
     else
     {
-      cout << "----" << endl << endl; //Otherwise, output dashes to represent
+      out << "----" << endl << endl; //Otherwise, output dashes to represent
     }                                 //no path
   }
 } //end of display
@@ -268,21 +423,21 @@ void GraphM::display(const int fromNode, const int toNode) const
 //             Receives a boolean parameter to determine if the NodeData
 //             from the data array is being printed, or the paths.
 //---------------------------------------------------------------------------
-void GraphM::printPath(const int fromNode, const int toNode, bool printData) const
+void GraphM::printPath(const int fromNode, const int toNode, bool printData, ostream &out) const
 {
   if (fromNode != toNode) //Recursive case - continue until back to starting node
   {
     if (T[fromNode][toNode].path != 0) //If the path isn't empty, trace it back
     {
-      printPath(fromNode, T[fromNode][toNode].path, printData); //Recursive call
+      printPath(fromNode, T[fromNode][toNode].path, printData, out); //Recursive call
     }                                                           //to find previous
   }                                                             //nodes in the path
   if (!printData)
   {
-    cout << toNode << " "; //If not asked to print data (locations), just print
+    out << toNode << " "; //If not asked to print data (locations), just print
   }                        //print the node in the path
   else
   {
-    cout << data[T[fromNode][toNode].path] << endl; //Otherwise print the data
+    out << data[T[fromNode][toNode].path] << endl; //Otherwise print the data
   }                                                 //for that node in the path
 } //end of printPath
@@ -13,12 +13,21 @@
 //Notes: Assumption: NodeData (container for strings of names of locations)
 //       provides proper data checking and overloads appropriate operators
 //       for comparison, and the file being provided is formatted correctly.
+//       The adjacency matrix is published as immutable, versioned snapshots
+//       (copy-on-write per row). Any number of threads may call
+//       shortestPath, shortestDistance and getVersion while one writer
+//       applies edge updates; each call answers from one version. buildGraph,
+//       findShortestPath, displayAll and display share T, and are still meant
+//       to be used from a single thread.
 //---------------------------------------------------------------------------
 #ifndef GRAPHM_H
 #define GRAPHM_H
 #include <iostream>
 #include <fstream>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "nodedata.h"
 using namespace std;
 
@@ -28,17 +37,29 @@ const int MAXNODES = 101;
 class GraphM
 {
 public:
+  struct EdgeUpdate
+  {
+    int fromNode; //Starting node of the edge
+    int toNode;   //Ending node of the edge
+    int weight;   //New cost of the edge, INFINITY removes it
+  };
+
   //Constructors
   GraphM();
   ~GraphM();
   //Getters
   void findShortestPath();
-  void displayAll() const;
-  void display(const int fromNode, const int toNode) const;
+  void displayAll(ostream &out = cout) const;
+  void display(const int fromNode, const int toNode, ostream &out = cout) const;
+  int shortestDistance(const int fromNode, const int toNode) const;
+  int shortestPath(const int fromNode, const int toNode, vector<int> &path) const;
+  long getVersion() const;
+  int getSize() const;
   //Setters
   bool buildGraph(ifstream &inFile);
   bool insertEdge(const int fromNode, const int toNode, const int weight);
   bool removeEdge(const int fromNode, const int toNode);
+  bool applyUpdates(const vector<EdgeUpdate> &updates);
 
 private:
   struct TableType
@@ -48,15 +69,29 @@ private:
     int path;     //Previous node in path of minimum distance
   };
 
+  struct CostRow
+  {
+    int cost[MAXNODES];             //Costs from one node to every other node
+  };
+
+  struct Snapshot
+  {
+    long version;                   //Number of published updates so far
+    shared_ptr<const CostRow> C[MAXNODES]; //Cost array, the adjacency matrix
+  };                                //(rows are shared between versions)
+
   NodeData data[MAXNODES];          //Data for graph nodes
-  int C[MAXNODES][MAXNODES];        //Cost array, the adjacency matrix
+  shared_ptr<const Snapshot> current; //Latest published adjacency matrix
+  mutex writeLock;                  //Serializes writers, never held by readers
   int size;                         //Number of nodes in the graph
   TableType T[MAXNODES][MAXNODES];  //Stores visited, distance, path
 
   //Utility and Helper
   void initializeC();
+  shared_ptr<const Snapshot> pinSnapshot() const;
+  bool validEdge(const int fromNode, const int toNode, const int weight) const;
   void initializeT(const bool onlyVisited);
   int findMinimum(const TableType data[]) const;
-  void printPath(const int from, const int to, bool printData) const;
+  void printPath(const int from, const int to, bool printData, ostream &out) const;
 };
 #endif
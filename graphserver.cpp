@@ -0,0 +1,716 @@
+//-------------------------------graphserver.cpp-----------------------------
+//Purpose: Implementation file for GraphServer class. GraphServer loads the
+//         GraphM graphs from one .txt file and the GraphL graphs from
+//         another, keeps them in memory, and answers requests for them over
+//         a Unix domain socket (see graphserver.h for the requests).
+//---------------------------------------------------------------------------
+//Notes: Only the event loop thread reads, writes, or closes sockets.
+//       Workers take the complete request lines of one connection at a
+//       time, answer them in order, and hand the replies back to the event
+//       loop through an eventfd. A connection is never being answered by
+//       two workers at once, which keeps pipelined replies in order.
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sstream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "graphserver.h"
+using namespace std;
+
+//-----------------------------GraphServer-----------------------------------
+//Description: Constructor - stores the socket path, the two graph files and
+//             the number of worker threads. Nothing is opened until
+//             loadGraphs and run are called.
+//---------------------------------------------------------------------------
+GraphServer::GraphServer(const string &socketPath, const string &matrixFile,
+                         const string &listFile, const int workers)
+  : socketPath(socketPath), ownsSocket(false), socketDevice(0), socketInode(0),
+    matrixFile(matrixFile), listFile(listFile),
+    workerCount(workers > 0 ? workers : 1), listenFd(-1), epollFd(-1),
+    wakeFd(-1), signalFd(-1), running(false), stopping(false)
+{
+} //end of GraphServer
+
+//----------------------------~GraphServer-----------------------------------
+//Description: Destructor - closes any sockets still open.
+//---------------------------------------------------------------------------
+GraphServer::~GraphServer()
+{
+  closeSockets();
+} //end of ~GraphServer
+
+//------------------------------loadGraphs-----------------------------------
+//Description: Public function to load every graph from both files, the same
+//             way lab3 does, and find the shortest paths of each GraphM.
+//             The new graphs replace the old ones only once both files have
+//             loaded; requests already running keep the graphs they started
+//             with. Returns false, keeping the old graphs, if either file
+//             cannot be opened.
+//---------------------------------------------------------------------------
+bool GraphServer::loadGraphs()
+{
+  lock_guard<mutex> guard(reloadLock);
+  ifstream matrixIn(matrixFile.c_str());
+  ifstream listIn(listFile.c_str());
+  if (!matrixIn || !listIn)
+  {
+    return false;
+  }
+  shared_ptr<GraphSet> loaded = make_shared<GraphSet>();
+  for (;;)
+  {
+    unique_ptr<GraphM> G(new GraphM);
+    G->buildGraph(matrixIn);
+    if (matrixIn.eof())
+    {
+      break;
+    }
+    G->findShortestPath(); //Answer every PATH and ALL from here on
+    loaded->matrices.push_back(move(G));
+  }
+  for (;;)
+  {
+    unique_ptr<GraphL> G(new GraphL);
+    G->buildGraph(listIn);
+    if (listIn.eof())
+    {
+      break;
+    }
+    loaded->lists.push_back(move(G));
+    loaded->dfsLocks.push_back(unique_ptr<mutex>(new mutex));
+  }
+  atomic_store(&graphs, shared_ptr<const GraphSet>(loaded));
+  return true;
+} //end of loadGraphs
+
+//---------------------------------run---------------------------------------
+//Description: Public function to open the socket, start the workers, and
+//             run the event loop until stop is called or SIGINT or SIGTERM
+//             arrives. Returns false if the socket could not be opened.
+//---------------------------------------------------------------------------
+bool GraphServer::run()
+{
+  if (!openSockets())
+  {
+    closeSockets();
+    return false;
+  }
+  stopping = false;
+  running = true;
+  for (int i = 0; i < workerCount; i++) //Started after signals are blocked,
+  {                                     //so only signalFd sees them
+    workers.push_back(thread(&GraphServer::workerLoop, this));
+  }
+  epoll_event events[64];
+  while (running)
+  {
+    int count = epoll_wait(epollFd, events, 64, -1);
+    if (count < 0 && errno != EINTR)
+    {
+      break;
+    }
+    for (int i = 0; i < count; i++)
+    {
+      int fd = events[i].data.fd;
+      if (fd == listenFd)
+      {
+        acceptConnections();
+      }
+      else if (fd == wakeFd)
+      {
+        flushReady();
+      }
+      else if (fd == signalFd)
+      {
+        handleSignal();
+      }
+      else
+      {
+        map<int, shared_ptr<Connection> >::iterator found = connections.find(fd);
+        if (found == connections.end())
+        {
+          continue; //Closed earlier in this batch
+        }
+        shared_ptr<Connection> conn = found->second;
+        if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+        {
+          readConnection(conn);
+        }
+        flushConnection(conn);
+        closeIfDone(conn);
+      }
+    }
+  }
+  {
+    lock_guard<mutex> guard(jobLock); //Let the workers finish what they have
+    stopping = true;
+  }
+  jobReady.notify_all();
+  for (size_t i = 0; i < workers.size(); i++)
+  {
+    workers[i].join();
+  }
+  workers.clear();
+  closeSockets();
+  return true;
+} //end of run
+
+//---------------------------------stop--------------------------------------
+//Description: Public function to make run return. Safe to call from any
+//             thread.
+//---------------------------------------------------------------------------
+void GraphServer::stop()
+{
+  running = false;
+  if (wakeFd >= 0)
+  {
+    uint64_t one = 1;
+    ssize_t ignored = write(wakeFd, &one, sizeof(one)); //Wake the event loop
+    (void)ignored;
+  }
+} //end of stop
+
+//------------------------------openSockets----------------------------------
+//Description: Private helper function to create the listening socket, the
+//             epoll instance, the eventfd the workers use to wake the event
+//             loop, and a signalfd for SIGHUP, SIGINT and SIGTERM. Fails,
+//             leaving the path alone, if something other than a stale
+//             socket is already there.
+//---------------------------------------------------------------------------
+bool GraphServer::openSockets()
+{
+  sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (socketPath.size() >= sizeof(address.sun_path))
+  {
+    return false; //Path too long for a Unix socket
+  }
+  strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+  listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listenFd < 0)
+  {
+    return false;
+  }
+  if (!removeStaleSocket(address) ||
+      bind(listenFd, (sockaddr *)&address, sizeof(address)) < 0)
+  {
+    return false;
+  }
+  struct stat bound;
+  if (lstat(socketPath.c_str(), &bound) == 0)
+  { //Remember which file is ours, so closeSockets removes only that one
+    ownsSocket = true;
+    socketDevice = bound.st_dev;
+    socketInode = bound.st_ino;
+  }
+  if (listen(listenFd, SOMAXCONN) < 0)
+  {
+    return false;
+  }
+
+  sigset_t mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGHUP);
+  sigaddset(&mask, SIGINT);
+  sigaddset(&mask, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+  signal(SIGPIPE, SIG_IGN); //Closed peers are seen as send errors instead
+
+  epollFd = epoll_create1(EPOLL_CLOEXEC);
+  wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  signalFd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+  if (epollFd < 0 || wakeFd < 0 || signalFd < 0)
+  {
+    return false;
+  }
+  int fds[3] = {listenFd, wakeFd, signalFd};
+  for (int i = 0; i < 3; i++)
+  {
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = fds[i];
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fds[i], &event) < 0)
+    {
+      return false;
+    }
+  }
+  return true;
+} //end of openSockets
+
+//---------------------------removeStaleSocket-------------------------------
+//Description: Private helper function to clear the way for bind. Returns
+//             true if nothing is at the socket path, or if a socket is
+//             there that no server accepts connections on, which is then
+//             removed. Returns false, removing nothing, for any other file
+//             or for a socket that is still in use.
+//---------------------------------------------------------------------------
+bool GraphServer::removeStaleSocket(const sockaddr_un &address) const
+{
+  struct stat existing;
+  if (lstat(socketPath.c_str(), &existing) < 0)
+  {
+    return errno == ENOENT;
+  }
+  if (!S_ISSOCK(existing.st_mode))
+  {
+    return false; //Not a socket, so never ours to remove
+  }
+  int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (probe < 0)
+  {
+    return false;
+  }
+  bool stale = (connect(probe, (const sockaddr *)&address, sizeof(address)) < 0 &&
+                errno == ECONNREFUSED);
+  close(probe);
+  return stale && unlink(socketPath.c_str()) == 0;
+} //end of removeStaleSocket
+
+//-----------------------------closeSockets----------------------------------
+//Description: Private helper function to close every connection and every
+//             descriptor opened by openSockets, and remove the socket file
+//             if it is still the one openSockets bound.
+//---------------------------------------------------------------------------
+void GraphServer::closeSockets()
+{
+  for (map<int, shared_ptr<Connection> >::iterator it = connections.begin();
+       it != connections.end(); ++it)
+  {
+    close(it->first);
+    it->second->fd = -1;
+  }
+  connections.clear();
+  if (listenFd >= 0)
+  {
+    close(listenFd);
+    listenFd = -1;
+  }
+  struct stat current;
+  if (ownsSocket && lstat(socketPath.c_str(), &current) == 0 && S_ISSOCK(current.st_mode) &&
+      current.st_dev == socketDevice && current.st_ino == socketInode)
+  {
+    unlink(socketPath.c_str());
+  }
+  ownsSocket = false;
+  int *fds[3] = {&epollFd, &wakeFd, &signalFd};
+  for (int i = 0; i < 3; i++)
+  {
+    if (*fds[i] >= 0)
+    {
+      close(*fds[i]);
+      *fds[i] = -1;
+    }
+  }
+} //end of closeSockets
+
+//--------------------------------submit-------------------------------------
+//Description: Private helper function to queue a job for the workers.
+//---------------------------------------------------------------------------
+void GraphServer::submit(const function<void()> &job)
+{
+  {
+    lock_guard<mutex> guard(jobLock);
+    jobs.push_back(job);
+  }
+  jobReady.notify_one();
+} //end of submit
+
+//------------------------------workerLoop-----------------------------------
+//Description: Private helper function run by each worker thread. Takes jobs
+//             until the server stops and the queue is empty.
+//---------------------------------------------------------------------------
+void GraphServer::workerLoop()
+{
+  for (;;)
+  {
+    function<void()> job;
+    {
+      unique_lock<mutex> guard(jobLock);
+      while (jobs.empty() && !stopping)
+      {
+        jobReady.wait(guard);
+      }
+      if (jobs.empty())
+      {
+        return; //Stopping, and nothing left to do
+      }
+      job = jobs.front();
+      jobs.pop_front();
+    }
+    job();
+  }
+} //end of workerLoop
+
+//---------------------------acceptConnections-------------------------------
+//Description: Private helper function to accept every waiting connection
+//             and register it with epoll.
+//---------------------------------------------------------------------------
+void GraphServer::acceptConnections()
+{
+  for (;;)
+  {
+    int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0)
+    {
+      return; //EAGAIN once there are no more, or a failed connection
+    }
+    shared_ptr<Connection> conn = make_shared<Connection>();
+    conn->fd = fd;
+    conn->busy = false;
+    conn->peerClosed = false;
+    conn->events = 0;
+    connections[fd] = conn;
+    lock_guard<mutex> guard(conn->lock);
+    updateEvents(conn);
+  }
+} //end of acceptConnections
+
+//----------------------------readConnection---------------------------------
+//Description: Private helper function to read what is available on a
+//             connection, up to MAXBUFFER bytes of waiting input. If it
+//             completes a request, a worker is given the connection.
+//---------------------------------------------------------------------------
+void GraphServer::readConnection(const shared_ptr<Connection> &conn)
+{
+  char buffer[4096];
+  lock_guard<mutex> guard(conn->lock);
+  while (!conn->peerClosed && conn->input.size() < MAXBUFFER)
+  {
+    ssize_t count = recv(conn->fd, buffer, sizeof(buffer), 0);
+    if (count > 0)
+    {
+      conn->input.append(buffer, count);
+    }
+    else if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+    {
+      break; //Read everything for now
+    }
+    else if (count < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    else
+    {
+      conn->peerClosed = true; //End of file, or the connection failed
+    }
+  }
+  size_t end = conn->input.rfind('\n');
+  size_t partial = (end == string::npos) ? conn->input.size() : conn->input.size() - end - 1;
+  if (partial > MAXREQUEST)
+  { //A request too long to be real, so stop reading from this client
+    conn->peerClosed = true;
+    conn->input.erase(conn->input.size() - partial);
+  }
+  dispatch(conn);
+  updateEvents(conn);
+} //end of readConnection
+
+//----------------------------flushConnection--------------------------------
+//Description: Private helper function to send as much of a connection's
+//             waiting replies as the socket will take, and watch for it to
+//             become writable if some are left. A connection paused because
+//             its replies filled MAXBUFFER is given to a worker again.
+//---------------------------------------------------------------------------
+void GraphServer::flushConnection(const shared_ptr<Connection> &conn)
+{
+  lock_guard<mutex> guard(conn->lock);
+  if (conn->fd < 0)
+  {
+    return;
+  }
+  while (!conn->output.empty())
+  {
+    ssize_t count = send(conn->fd, conn->output.data(), conn->output.size(), MSG_NOSIGNAL);
+    if (count > 0)
+    {
+      conn->output.erase(0, count);
+    }
+    else if (count < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    else if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+    {
+      break; //Socket is full, try again once epoll says it is writable
+    }
+    else
+    { //The client has gone, so its replies can never be sent
+      conn->peerClosed = true;
+      conn->output.clear();
+      conn->input.clear();
+    }
+  }
+  dispatch(conn);
+  updateEvents(conn);
+} //end of flushConnection
+
+//-------------------------------dispatch------------------------------------
+//Description: Private helper function to give a connection to a worker if
+//             it has a complete request, no worker is answering it, and its
+//             waiting replies are under MAXBUFFER. Called with the
+//             connection's lock held.
+//---------------------------------------------------------------------------
+void GraphServer::dispatch(const shared_ptr<Connection> &conn)
+{
+  if (conn->busy || conn->output.size() >= MAXBUFFER ||
+      conn->input.find('\n') == string::npos)
+  {
+    return;
+  }
+  conn->busy = true;
+  shared_ptr<Connection> job = conn;
+  submit([this, job]() { serve(job); });
+} //end of dispatch
+
+//-----------------------------updateEvents----------------------------------
+//Description: Private helper function to register the events a connection
+//             needs with epoll: input until the client closes, unless its
+//             input or output is over MAXBUFFER, and output while replies
+//             are waiting. A connection that needs neither is
+//             removed from epoll, so a closed client cannot keep waking the
+//             loop while a worker finishes its last replies. Called with the
+//             connection's lock held.
+//---------------------------------------------------------------------------
+void GraphServer::updateEvents(const shared_ptr<Connection> &conn)
+{
+  unsigned wanted = 0;
+  if (!conn->peerClosed && conn->input.size() < MAXBUFFER &&
+      conn->output.size() < MAXBUFFER)
+  {
+    wanted |= EPOLLIN | EPOLLRDHUP;
+  }
+  if (!conn->output.empty())
+  {
+    wanted |= EPOLLOUT;
+  }
+  if (wanted == conn->events)
+  {
+    return;
+  }
+  epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = wanted;
+  event.data.fd = conn->fd;
+  if (wanted == 0)
+  {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, conn->fd, &event);
+  }
+  else
+  {
+    epoll_ctl(epollFd, conn->events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, conn->fd, &event);
+  }
+  conn->events = wanted;
+} //end of updateEvents
+
+//------------------------------closeIfDone----------------------------------
+//Description: Private helper function to close a connection once the client
+//             has closed it, no worker is answering it, and every request
+//             has been answered and every reply sent.
+//---------------------------------------------------------------------------
+void GraphServer::closeIfDone(const shared_ptr<Connection> &conn)
+{
+  lock_guard<mutex> guard(conn->lock);
+  if (conn->fd < 0 || !conn->peerClosed || conn->busy || !conn->output.empty() ||
+      conn->input.find('\n') != string::npos)
+  {
+    return;
+  }
+  if (conn->events != 0)
+  {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, conn->fd, nullptr);
+  }
+  connections.erase(conn->fd);
+  close(conn->fd);
+  conn->fd = -1;
+} //end of closeIfDone
+
+//-------------------------------flushReady----------------------------------
+//Description: Private helper function, run when a worker signals wakeFd, to
+//             send the new replies of every connection it has answered.
+//---------------------------------------------------------------------------
+void GraphServer::flushReady()
+{
+  uint64_t count;
+  ssize_t ignored = read(wakeFd, &count, sizeof(count)); //Reset the eventfd
+  (void)ignored;
+  vector<shared_ptr<Connection> > answered;
+  {
+    lock_guard<mutex> guard(readyLock);
+    answered.swap(ready);
+  }
+  for (size_t i = 0; i < answered.size(); i++)
+  {
+    flushConnection(answered[i]);
+    closeIfDone(answered[i]);
+  }
+} //end of flushReady
+
+//------------------------------handleSignal---------------------------------
+//Description: Private helper function to act on a signal: SIGHUP reloads the
+//             graphs on a worker, SIGINT and SIGTERM stop the server.
+//---------------------------------------------------------------------------
+void GraphServer::handleSignal()
+{
+  signalfd_siginfo info;
+  while (read(signalFd, &info, sizeof(info)) == sizeof(info))
+  {
+    if (info.ssi_signo == SIGHUP)
+    {
+      submit([this]() { loadGraphs(); });
+    }
+    else
+    {
+      running = false;
+    }
+  }
+} //end of handleSignal
+
+//---------------------------------serve-------------------------------------
+//Description: Private helper function run on a worker to answer the
+//             complete requests of one connection, in order, until none are
+//             left or its waiting replies reach MAXBUFFER. Each reply is
+//             handed to the event loop as soon as it is ready.
+//---------------------------------------------------------------------------
+void GraphServer::serve(const shared_ptr<Connection> &conn)
+{
+  for (;;)
+  {
+    string request;
+    {
+      lock_guard<mutex> guard(conn->lock);
+      size_t end = conn->input.find('\n');
+      if (end == string::npos || conn->output.size() >= MAXBUFFER)
+      { //The event loop gives it out again on more input, or once the
+        conn->busy = false; //client has read enough replies
+        break;
+      }
+      request = conn->input.substr(0, end);
+      conn->input.erase(0, end + 1);
+    }
+    string reply = answer(request);
+    {
+      lock_guard<mutex> guard(conn->lock);
+      conn->output += reply;
+    }
+    markReady(conn);
+  }
+  markReady(conn); //So the event loop can close it if the client has gone
+} //end of serve
+
+//-------------------------------markReady-----------------------------------
+//Description: Private helper function to tell the event loop a connection
+//             has new replies.
+//---------------------------------------------------------------------------
+void GraphServer::markReady(const shared_ptr<Connection> &conn)
+{
+  {
+    lock_guard<mutex> guard(readyLock);
+    ready.push_back(conn);
+  }
+  uint64_t one = 1;
+  ssize_t ignored = write(wakeFd, &one, sizeof(one));
+  (void)ignored;
+} //end of markReady
+
+//--------------------------------answer-------------------------------------
+//Description: Private helper function to answer one request line on the
+//             graphs loaded when it starts. Returns the reply, ending with
+//             the "." line.
+//---------------------------------------------------------------------------
+string GraphServer::answer(const string &request)
+{
+  shared_ptr<const GraphSet> current = atomic_load(&graphs);
+  istringstream in(request);
+  ostringstream out;
+  string command;
+  int which = 0, fromNode = 0, toNode = 0;
+  in >> command;
+  bool matrixRequest = (command == "PATH" || command == "ALL" || command == "DIST");
+  bool listRequest = (command == "GRAPH" || command == "DFS" || command == "REACH");
+  bool twoNodes = (command == "PATH" || command == "DIST" || command == "REACH");
+
+  if (command == "RELOAD")
+  {
+    if (loadGraphs())
+    {
+      current = atomic_load(&graphs);
+      out << "reloaded " << current->matrices.size() << " " << current->lists.size() << endl;
+    }
+    else
+    {
+      out << "error: graph files could not be opened" << endl;
+    }
+  }
+  else if (command == "STATS")
+  {
+    for (size_t i = 0; i < current->lists.size(); i++)
+    {
+      out << "list " << i + 1 << " index " << current->lists[i]->getIndexSize()
+          << " bytes" << endl;
+    }
+  }
+  else if (!matrixRequest && !listRequest)
+  {
+    out << "error: unknown request" << endl;
+  }
+  else if (!(in >> which) || (twoNodes && !(in >> fromNode >> toNode)))
+  {
+    out << "error: missing graph or node numbers" << endl;
+  }
+  else if (which < 1 || (matrixRequest && which > (int)current->matrices.size()) ||
+           (listRequest && which > (int)current->lists.size()))
+  {
+    out << "error: no such graph" << endl;
+  }
+  else if (twoNodes && (min(fromNode, toNode) < 1 ||
+           max(fromNode, toNode) > (matrixRequest ? current->matrices[which - 1]->getSize()
+                                                  : current->lists[which - 1]->getSize())))
+  {
+    out << "error: no such node" << endl;
+  }
+  else if (command == "PATH")
+  {
+    current->matrices[which - 1]->display(fromNode, toNode, out);
+  }
+  else if (command == "ALL")
+  {
+    current->matrices[which - 1]->displayAll(out);
+  }
+  else if (command == "DIST")
+  {
+    int dist = current->matrices[which - 1]->shortestDistance(fromNode, toNode);
+    if (dist == INFINITY)
+    {
+      out << "----" << endl;
+    }
+    else
+    {
+      out << dist << endl;
+    }
+  }
+  else if (command == "GRAPH")
+  {
+    current->lists[which - 1]->displayGraph(out);
+  }
+  else if (command == "DFS")
+  {
+    lock_guard<mutex> guard(*current->dfsLocks[which - 1]);
+    current->lists[which - 1]->depthFirstSearch(out);
+  }
+  else //REACH
+  {
+    out << (current->lists[which - 1]->reachable(fromNode, toNode) ? "yes" : "no") << endl;
+  }
+  out << "." << endl;
+  return out.str();
+} //end of answer
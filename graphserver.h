@@ -0,0 +1,127 @@
+//--------------------------------graphserver.h------------------------------
+//Purpose: Header file for GraphServer class. GraphServer loads the GraphM
+//         graphs from one .txt file and the GraphL graphs from another (the
+//         same files lab3 reads), keeps them in memory, and answers requests
+//         for them over a Unix domain socket. One thread runs an epoll event
+//         loop for every connection, and a pool of worker threads answers
+//         the requests.
+//---------------------------------------------------------------------------
+//Notes: Requests are one line each, and every reply ends with a line holding
+//       a single ".". Graphs are numbered from 1 in the order they appear
+//       in their file.
+//         PATH m from to   shortest path in GraphM m, as display prints it
+//         ALL m            every shortest path in GraphM m, as displayAll
+//         DIST m from to   shortest distance in GraphM m
+//         GRAPH l          GraphL l, as displayGraph prints it
+//         DFS l            depth-first ordering of GraphL l
+//         REACH l from to  "yes" if from can reach to in GraphL l, or "no"
+//         STATS            reachability index size of each GraphL
+//         RELOAD           reload both files from disk
+//       A client may send many requests without waiting for replies; the
+//       replies come back in the same order. A reload (RELOAD or SIGHUP)
+//       swaps in the new graphs only once they are fully built, and
+//       requests already running finish on the graphs they started with,
+//       so no connection is dropped. SIGINT and SIGTERM stop the server.
+//       A connection with more than MAXBUFFER bytes of requests or replies
+//       waiting is not read from or answered until the client catches up.
+//       The server will not start on a path that is not a socket, or on a
+//       socket another server is listening on.
+//---------------------------------------------------------------------------
+#ifndef GRAPHSERVER_H
+#define GRAPHSERVER_H
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+#include <sys/un.h>
+#include "graphl.h"
+#include "graphm.h"
+using namespace std;
+
+const size_t MAXREQUEST = 4096; //Longest request line accepted, in bytes
+const size_t MAXBUFFER = 1 << 20; //Bytes a connection may have waiting in
+                                  //input or output before it is paused
+
+class GraphServer
+{
+public:
+  //Constructors
+  GraphServer(const string &socketPath, const string &matrixFile,
+              const string &listFile, const int workers);
+  ~GraphServer();
+  //Setters
+  bool loadGraphs();
+  bool run();
+  void stop();
+
+private:
+  struct GraphSet
+  {
+    vector<unique_ptr<GraphM> > matrices; //Graphs from matrixFile
+    vector<unique_ptr<GraphL> > lists;    //Graphs from listFile
+    vector<unique_ptr<mutex> > dfsLocks;  //One per list, depthFirstSearch
+  };                                      //marks nodes as it goes
+
+  struct Connection
+  {
+    int fd;            //Socket, -1 once closed
+    mutex lock;        //Guards everything below
+    string input;      //Bytes received, not yet answered
+    string output;     //Replies not yet sent
+    bool busy;         //A worker is answering its requests
+    bool peerClosed;   //Nothing more will be read
+    unsigned events;   //Events registered with epoll, 0 if not registered
+  };
+
+  string socketPath;
+  bool ownsSocket;                   //socketPath is the socket bound here,
+  dev_t socketDevice;                //identified by device and inode
+  ino_t socketInode;
+  string matrixFile;
+  string listFile;
+  int workerCount;
+  shared_ptr<const GraphSet> graphs; //Latest loaded graphs
+  mutex reloadLock;                  //One reload at a time
+
+  int listenFd;
+  int epollFd;
+  int wakeFd;                        //eventfd, workers signal replies
+  int signalFd;
+  atomic<bool> running;
+  map<int, shared_ptr<Connection> > connections; //Event loop thread only
+
+  vector<thread> workers;
+  mutex jobLock;                     //Guards jobs and stopping
+  condition_variable jobReady;
+  deque<function<void()> > jobs;
+  bool stopping;
+
+  mutex readyLock;                   //Guards ready
+  vector<shared_ptr<Connection> > ready; //Connections with new replies
+
+  //Utility and Helper Functions
+  bool openSockets();
+  bool removeStaleSocket(const sockaddr_un &address) const;
+  void closeSockets();
+  void submit(const function<void()> &job);
+  void workerLoop();
+  void acceptConnections();
+  void readConnection(const shared_ptr<Connection> &conn);
+  void flushConnection(const shared_ptr<Connection> &conn);
+  void dispatch(const shared_ptr<Connection> &conn);
+  void updateEvents(const shared_ptr<Connection> &conn);
+  void closeIfDone(const shared_ptr<Connection> &conn);
+  void flushReady();
+  void handleSignal();
+  void serve(const shared_ptr<Connection> &conn);
+  void markReady(const shared_ptr<Connection> &conn);
+  string answer(const string &request);
+};
+#endif
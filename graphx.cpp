@@ -0,0 +1,629 @@
+//-----------------------------------graphx.cpp------------------------------
+//Purpose: Implementation file for GraphX class. GraphX builds an adjacency
+//         file from the GraphM or GraphL .txt format without holding the
+//         edges in memory, and searches the file through a read-only memory
+//         mapping (see graphx.h for the file layout).
+//---------------------------------------------------------------------------
+//Notes: Building is an external merge sort. Edges are read into a buffer
+//       the size of the memory limit; each full buffer is sorted by
+//       starting node and written out as a run. Runs are merged MAXMERGE at
+//       a time until few enough are left for one final merge, which writes
+//       the adjacency file in a single pass.
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "graphx.h"
+using namespace std;
+
+static const char MAGIC[8] = "GRAPHX1";
+static const size_t RUNBUFFER = 1 << 20; //Bytes of read buffer per run
+
+//-------------------------------RunMerger-----------------------------------
+//Description: Private helper that reads a set of sorted run files as one
+//             sorted sequence of edges, keeping only the next edge of each
+//             run in memory.
+//---------------------------------------------------------------------------
+struct GraphX::RunMerger
+{
+  struct Run
+  {
+    ifstream in;
+    vector<char> buffer;
+  };
+  vector<unique_ptr<Run> > runs;
+  priority_queue<pair<Edge, size_t>, vector<pair<Edge, size_t> >,
+                 greater<pair<Edge, size_t> > > next; //Next edge of each run
+
+  bool open(const vector<string> &names)
+  {
+    for (size_t i = 0; i < names.size(); i++)
+    {
+      unique_ptr<Run> run(new Run);
+      run->buffer.resize(RUNBUFFER);
+      run->in.rdbuf()->pubsetbuf(&run->buffer[0], run->buffer.size());
+      run->in.open(names[i].c_str(), ios::binary);
+      if (!run->in)
+      {
+        return false;
+      }
+      runs.push_back(move(run));
+      advance(i);
+    }
+    return true;
+  }
+
+  void advance(const size_t i) //Queue the next edge of run i, if any
+  {
+    Edge edge;
+    if (runs[i]->in.read((char *)&edge, sizeof(edge)))
+    {
+      next.push(make_pair(edge, i));
+    }
+  }
+
+  bool read(Edge &edge) //Take the smallest edge of all the runs
+  {
+    if (next.empty())
+    {
+      return false;
+    }
+    edge = next.top().first;
+    size_t i = next.top().second;
+    next.pop();
+    advance(i);
+    return true;
+  }
+};
+
+//-------------------------------operator<-----------------------------------
+//Description: Orders edges by starting node, then ending node, then weight.
+//---------------------------------------------------------------------------
+bool GraphX::Edge::operator<(const Edge &rhs) const
+{
+  if (fromNode != rhs.fromNode)
+  {
+    return fromNode < rhs.fromNode;
+  }
+  if (toNode != rhs.toNode)
+  {
+    return toNode < rhs.toNode;
+  }
+  return weight < rhs.weight;
+} //end of operator<
+
+//--------------------------------GraphX-------------------------------------
+//Description: Empty Constructor - no adjacency file is open.
+//---------------------------------------------------------------------------
+GraphX::GraphX()
+{
+  this->fd = -1;
+  this->mapped = nullptr;
+  this->mappedSize = 0;
+  this->size = 0;
+  this->edgeCount = 0;
+  this->weighted = false;
+  this->compressed = false;
+  this->offsets = nullptr;
+  this->targets = nullptr;
+  this->weights = nullptr;
+  this->lists = nullptr;
+} //end of GraphX
+
+//-------------------------------~GraphX-------------------------------------
+//Description: Destructor - unmaps and closes the adjacency file. The file
+//             itself is left on disk.
+//---------------------------------------------------------------------------
+GraphX::~GraphX()
+{
+  close();
+} //end of ~GraphX
+
+//-------------------------------buildGraph----------------------------------
+//Description: Public function to read a graph from a .txt file and write it
+//             to an adjacency file, holding at most memoryLimit bytes of
+//             edges in memory at once. Reads the number of nodes, then the
+//             names (copied to <fileName>.names), then edges until the end of
+//             the file or an edge of zeros. Edges have a weight only if
+//             weighted is true. If compressed is true, the lists are written
+//             as CompressedAdjacency lists. Opens the finished file for
+//             searching. Returns false if the graph is empty or a file cannot
+//             be written.
+//---------------------------------------------------------------------------
+bool GraphX::buildGraph(ifstream &inFile, const string &fileName, const bool weighted,
+                        const size_t memoryLimit, const bool compressed)
+{
+  close();
+  long long nodes = 0;
+  inFile >> nodes; //Establish size based on number of nodes
+  if (nodes <= 0 || nodes > numeric_limits<uint32_t>::max())
+  {
+    return false;
+  }
+  string line;
+  getline(inFile, line); //Finish the line holding the number of nodes
+  ofstream names((fileName + ".names").c_str());
+  for (long long i = 1; i <= nodes; i++)
+  { //Copy each name without keeping it
+    getline(inFile, line);
+    names << line << '\n';
+  }
+  if (!names)
+  {
+    return false;
+  }
+
+  size_t capacity = max(memoryLimit / sizeof(Edge), (size_t)1);
+  vector<Edge> buffer; //Edges read since the last run was written
+  buffer.reserve(capacity);
+  vector<string> runs;
+  long long kept = 0;
+  bool written = true;
+  for (;;) //Loop until broken
+  {
+    long long fromNode, toNode, weight = 1;
+    inFile >> fromNode >> toNode;
+    if (weighted)
+    {
+      inFile >> weight;
+    }
+    if (inFile.eof() || !inFile)
+    {
+      break;
+    } //Break if at the end of the file, or if the values of the variables are 0
+    if (fromNode == 0 || toNode == 0 || weight == 0)
+    {
+      break;
+    }
+    if (fromNode < 1 || toNode < 1 || fromNode > nodes || toNode > nodes ||
+        fromNode == toNode || weight < 0 || weight > numeric_limits<int32_t>::max())
+    {
+      continue; //Not an edge on this graph
+    }
+    Edge edge = {(uint32_t)fromNode, (uint32_t)toNode, (int32_t)weight};
+    buffer.push_back(edge);
+    kept++;
+    if (buffer.size() == capacity)
+    { //Buffer full, so sort it out to disk
+      runs.push_back(fileName + ".run" + to_string(runs.size()));
+      if (!writeRun(buffer, runs.back()))
+      {
+        written = false;
+        break;
+      }
+    }
+  }
+  if (written && (!buffer.empty() || runs.empty()))
+  {
+    runs.push_back(fileName + ".run" + to_string(runs.size()));
+    written = writeRun(buffer, runs.back());
+  }
+
+  int pass = 0;
+  while (written && runs.size() > (size_t)MAXMERGE)
+  { //Too many runs to merge at once, so merge them in groups first
+    vector<string> merged;
+    size_t i = 0;
+    for (; written && i < runs.size(); i += MAXMERGE)
+    {
+      vector<string> group(runs.begin() + i, runs.begin() + min(i + MAXMERGE, runs.size()));
+      merged.push_back(fileName + ".pass" + to_string(pass) + "." + to_string(merged.size()));
+      written = mergeRuns(group, merged.back());
+      for (size_t j = 0; j < group.size(); j++)
+      {
+        remove(group[j].c_str());
+      }
+    }
+    for (; i < runs.size(); i++)
+    { //A merge failed, so these runs were never reached
+      remove(runs[i].c_str());
+    }
+    runs.swap(merged);
+    pass++;
+  }
+  if (written)
+  {
+    written = writeAdjacency(runs, fileName, nodes, kept, weighted, compressed);
+  }
+  for (size_t i = 0; i < runs.size(); i++)
+  {
+    remove(runs[i].c_str());
+  }
+  return written && open(fileName);
+} //end of buildGraph
+
+//--------------------------------writeRun-----------------------------------
+//Description: Private helper function to sort a buffer of edges, write it to
+//             a run file, and empty the buffer.
+//---------------------------------------------------------------------------
+bool GraphX::writeRun(vector<Edge> &edges, const string &runName) const
+{
+  sort(edges.begin(), edges.end());
+  ofstream out(runName.c_str(), ios::binary | ios::trunc);
+  if (!edges.empty())
+  {
+    out.write((const char *)&edges[0], edges.size() * sizeof(Edge));
+  }
+  edges.clear();
+  return (bool)out;
+} //end of writeRun
+
+//-------------------------------mergeRuns-----------------------------------
+//Description: Private helper function to merge sorted run files into one
+//             sorted run file.
+//---------------------------------------------------------------------------
+bool GraphX::mergeRuns(const vector<string> &runs, const string &outName) const
+{
+  RunMerger merger;
+  if (!merger.open(runs))
+  {
+    return false;
+  }
+  vector<char> buffer(RUNBUFFER);
+  ofstream out;
+  out.rdbuf()->pubsetbuf(&buffer[0], buffer.size());
+  out.open(outName.c_str(), ios::binary | ios::trunc);
+  Edge edge;
+  while (merger.read(edge))
+  {
+    out.write((const char *)&edge, sizeof(edge));
+  }
+  return (bool)out;
+} //end of mergeRuns
+
+//-----------------------------writeAdjacency--------------------------------
+//Description: Private helper function to merge the last sorted runs into
+//             the adjacency file. Edges arrive ordered by starting node, so
+//             the offsets, targets and weights sections are each written
+//             front to back, through their own stream, in the one pass.
+//             Compressed lists are encoded as the edges arrive, and their
+//             offsets count bytes rather than edges.
+//---------------------------------------------------------------------------
+bool GraphX::writeAdjacency(const vector<string> &runs, const string &fileName,
+                            const long long nodes, const long long edges,
+                            const bool weighted, const bool compressed) const
+{
+  RunMerger merger;
+  if (!merger.open(runs))
+  {
+    return false;
+  }
+  Header header;
+  memcpy(header.magic, MAGIC, sizeof(header.magic));
+  header.nodes = nodes;
+  header.edges = edges;
+  header.weighted = weighted ? 1 : 0;
+  header.compressed = compressed ? 1 : 0;
+  streamoff targetStart = sizeof(Header) + (nodes + 2) * sizeof(uint64_t);
+  streamoff weightStart = targetStart + edges * sizeof(uint32_t);
+
+  ofstream offsetOut(fileName.c_str(), ios::binary | ios::trunc);
+  offsetOut.write((const char *)&header, sizeof(header));
+  offsetOut.flush(); //Create the file before the other sections open it
+  fstream targetOut(fileName.c_str(), ios::binary | ios::in | ios::out);
+  fstream weightOut(fileName.c_str(), ios::binary | ios::in | ios::out);
+  targetOut.seekp(targetStart);
+  weightOut.seekp(weightStart);
+
+  uint64_t count = 0;    //Edges written so far
+  uint64_t position = 0; //Bytes of compressed lists written so far
+  uint32_t last = 0;     //Previous neighbor in the current compressed list
+  vector<unsigned char> encoded; //Encoding of one compressed edge
+  long long nextNode = 0; //Next node whose offset is due
+  Edge edge;
+  while (merger.read(edge))
+  {
+    uint64_t offset = compressed ? position : count;
+    if (nextNode <= (long long)edge.fromNode)
+    {
+      last = 0; //A new list starts
+    }
+    while (nextNode <= (long long)edge.fromNode)
+    { //Every node up to this one starts at the current edge
+      offsetOut.write((const char *)&offset, sizeof(offset));
+      nextNode++;
+    }
+    if (compressed)
+    {
+      encoded.clear();
+      CompressedAdjacency::encode(edge.toNode - last, encoded);
+      if (weighted)
+      {
+        CompressedAdjacency::encode(edge.weight, encoded);
+      }
+      targetOut.write((const char *)&encoded[0], encoded.size());
+      position += encoded.size();
+      last = edge.toNode;
+    }
+    else
+    {
+      targetOut.write((const char *)&edge.toNode, sizeof(edge.toNode));
+      if (weighted)
+      {
+        weightOut.write((const char *)&edge.weight, sizeof(edge.weight));
+      }
+    }
+    count++;
+  }
+  uint64_t offset = compressed ? position : count;
+  while (nextNode <= nodes + 1)
+  { //The remaining nodes, and the end of the last node, are past every edge
+    offsetOut.write((const char *)&offset, sizeof(offset));
+    nextNode++;
+  }
+  offsetOut.close();
+  targetOut.close();
+  weightOut.close();
+  return count == (uint64_t)edges && !offsetOut.fail() && !targetOut.fail() && !weightOut.fail();
+} //end of writeAdjacency
+
+//---------------------------------open--------------------------------------
+//Description: Public function to map an adjacency file written by
+//             buildGraph. Returns false if it cannot be opened or is not a
+//             complete adjacency file, including if any node's offsets fall
+//             outside its section or before the previous node's, so that
+//             searches never read past the mapping.
+//---------------------------------------------------------------------------
+bool GraphX::open(const string &fileName)
+{
+  close();
+  fd = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat status;
+  if (fd < 0 || fstat(fd, &status) < 0 || (size_t)status.st_size < sizeof(Header))
+  {
+    close();
+    return false;
+  }
+  mappedSize = status.st_size;
+  mapped = mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+  if (mapped == MAP_FAILED)
+  {
+    mapped = nullptr;
+    close();
+    return false;
+  }
+  const Header *header = (const Header *)mapped;
+  size_t room = (mappedSize - sizeof(Header)) / sizeof(uint64_t);
+  if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->nodes + 2 > room ||
+      header->nodes > numeric_limits<uint32_t>::max())
+  {
+    close();
+    return false;
+  }
+  size_t listStart = sizeof(Header) + (header->nodes + 2) * sizeof(uint64_t);
+  const uint64_t *sections = (const uint64_t *)(header + 1);
+  uint64_t listEnd = header->compressed ? sections[header->nodes + 1] : header->edges;
+  size_t width = header->compressed ? 1 : (header->weighted ? 8 : 4);
+  bool valid = listEnd <= (mappedSize - listStart) / width &&
+               listStart + listEnd * width == mappedSize && sections[0] == 0;
+  for (uint64_t v = 0; valid && v <= header->nodes; v++)
+  { //Each node's list must start where the last ended and stay in its section
+    valid = sections[v] <= sections[v + 1] && sections[v + 1] <= listEnd;
+  }
+  if (!valid)
+  {
+    close();
+    return false;
+  }
+  size = header->nodes;
+  edgeCount = header->edges;
+  weighted = header->weighted != 0;
+  compressed = header->compressed != 0;
+  offsets = sections;
+  if (compressed)
+  {
+    lists = (const unsigned char *)(offsets + size + 2);
+  }
+  else
+  {
+    targets = (const uint32_t *)(offsets + size + 2);
+    weights = weighted ? (const int32_t *)(targets + edgeCount) : nullptr;
+  }
+  return true;
+} //end of open
+
+//---------------------------------close-------------------------------------
+//Description: Public function to unmap and close the adjacency file, if one
+//             is open.
+//---------------------------------------------------------------------------
+void GraphX::close()
+{
+  if (mapped != nullptr)
+  {
+    munmap(mapped, mappedSize);
+  }
+  if (fd >= 0)
+  {
+    ::close(fd);
+  }
+  fd = -1;
+  mapped = nullptr;
+  mappedSize = 0;
+  size = 0;
+  edgeCount = 0;
+  weighted = false;
+  compressed = false;
+  offsets = nullptr;
+  targets = nullptr;
+  weights = nullptr;
+  lists = nullptr;
+} //end of close
+
+//--------------------------------edgesOf------------------------------------
+//Description: Private helper function to return a cursor at the first edge
+//             of node v, in either list format.
+//---------------------------------------------------------------------------
+GraphX::EdgeCursor GraphX::edgesOf(const uint32_t v) const
+{
+  EdgeCursor cursor;
+  cursor.next = offsets[v];
+  cursor.end = offsets[v + 1];
+  if (compressed)
+  {
+    cursor.list = CompressedAdjacency::makeCursor(lists + offsets[v], lists + offsets[v + 1], weighted);
+  }
+  return cursor;
+} //end of edgesOf
+
+//--------------------------------nextEdge-----------------------------------
+//Description: Private helper function to read the next edge at a cursor:
+//             its ending node, and its weight (1 if unweighted). Returns
+//             false once every edge of the node has been read, or at an edge
+//             to a node that is not on the graph or with a negative weight,
+//             which only a damaged file can hold.
+//---------------------------------------------------------------------------
+bool GraphX::nextEdge(EdgeCursor &cursor, uint32_t &target, int &weight) const
+{
+  if (compressed)
+  {
+    int next;
+    if (!cursor.list.next(next, weight))
+    {
+      return false;
+    }
+    target = next;
+  }
+  else
+  {
+    if (cursor.next == cursor.end)
+    {
+      return false;
+    }
+    target = targets[cursor.next];
+    weight = weighted ? weights[cursor.next] : 1;
+    cursor.next++;
+  }
+  return target >= 1 && target <= (uint64_t)size && weight >= 0;
+} //end of nextEdge
+
+//--------------------------depthFirstSearch---------------------------------
+//Description: Public function to output the depth-first ordering of the
+//             whole graph, in the same format as GraphL. Neighbors are
+//             visited in increasing order. Uses its own stack rather than
+//             recursion, since large graphs can be far deeper than the call
+//             stack allows.
+//---------------------------------------------------------------------------
+bool GraphX::depthFirstSearch(ostream &out) const
+{
+  if (this->size == 0) //If the graph is empty, do nothing
+  {
+    return false;
+  }
+  vector<bool> visited(size + 1, false);
+  vector<EdgeCursor> stack; //Next edge to follow of each node on the path
+  out << "Depth-first ordering: ";
+  for (long long s = 1; s <= size; s++)
+  {
+    if (visited[s])
+    {
+      continue;
+    }
+    visited[s] = true;
+    out << s << " ";
+    stack.push_back(edgesOf(s));
+    while (!stack.empty())
+    {
+      uint32_t w;
+      int weight;
+      if (!nextEdge(stack.back(), w, weight))
+      {
+        stack.pop_back(); //Every edge of this node followed
+      }
+      else if (!visited[w])
+      {
+        visited[w] = true;
+        out << w << " ";
+        stack.push_back(edgesOf(w));
+      }
+    }
+  }
+  out << endl << endl; //Double new line to stay consistent with GraphL
+  return true;
+} //end of depthFirstSearch
+
+//---------------------------shortestDistance--------------------------------
+//Description: Public function to find the shortest distance between two
+//             nodes with Dijkstra's algorithm, using a heap so only the edges
+//             of settled nodes are paged in. Unweighted edges cost 1.
+//             Returns -1 if there is no path.
+//---------------------------------------------------------------------------
+long long GraphX::shortestDistance(const int fromNode, const int toNode) const
+{
+  if (fromNode < 1 || toNode < 1 || fromNode > size || toNode > size)
+  {
+    return -1;
+  }
+  const long long unreached = numeric_limits<long long>::max();
+  vector<long long> dist(size + 1, unreached);
+  priority_queue<pair<long long, uint32_t>, vector<pair<long long, uint32_t> >,
+                 greater<pair<long long, uint32_t> > > heap;
+  dist[fromNode] = 0;
+  heap.push(make_pair(0LL, (uint32_t)fromNode));
+  while (!heap.empty())
+  {
+    long long d = heap.top().first;
+    uint32_t v = heap.top().second;
+    heap.pop();
+    if (d != dist[v])
+    {
+      continue; //Already settled with a shorter distance
+    }
+    if (v == (uint32_t)toNode)
+    {
+      return d;
+    }
+    EdgeCursor cursor = edgesOf(v);
+    uint32_t w;
+    int weight;
+    while (nextEdge(cursor, w, weight))
+    {
+      long long next = d + weight;
+      if (next < dist[w])
+      {
+        dist[w] = next;
+        heap.push(make_pair(next, w));
+      }
+    }
+  }
+  return -1;
+} //end of shortestDistance
+
+//-------------------------------getSize-------------------------------------
+//Description: Public function to return the number of nodes.
+//---------------------------------------------------------------------------
+long long GraphX::getSize() const
+{
+  return size;
+} //end of getSize
+
+//-----------------------------getEdgeCount----------------------------------
+//Description: Public function to return the number of edges.
+//---------------------------------------------------------------------------
+long long GraphX::getEdgeCount() const
+{
+  return edgeCount;
+} //end of getEdgeCount
+
+//--------------------------getCompressionRatio------------------------------
+//Description: Public function to return how many times smaller the lists
+//             and their offsets are than they would be uncompressed. Returns
+//             1 if the file is not compressed.
+//---------------------------------------------------------------------------
+double GraphX::getCompressionRatio() const
+{
+  if (!compressed)
+  {
+    return 1.0;
+  }
+  double offsetBytes = (size + 2) * sizeof(uint64_t);
+  double plain = offsetBytes + edgeCount * (weighted ? 8.0 : 4.0);
+  return plain / (offsetBytes + offsets[size + 1]);
+} //end of getCompressionRatio
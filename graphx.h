@@ -0,0 +1,105 @@
+//-----------------------------------graphx.h--------------------------------
+//Purpose: Header file for GraphX class. GraphX reads the same .txt format as
+//         GraphM (weighted) or GraphL (unweighted), but never holds the
+//         edges in memory. buildGraph streams the edges into sorted runs on
+//         disk, no larger than a given memory limit, then merges the runs
+//         into one adjacency file. The file is mapped into memory, so the
+//         operating system pages in only the parts a search touches.
+//---------------------------------------------------------------------------
+//Notes: Adjacency file layout, all little-endian:
+//         Header                            magic, nodes, edges, weighted,
+//                                           compressed
+//         uint64 offsets[nodes + 2]         edges of v are offsets[v] to
+//                                           offsets[v + 1] - 1
+//         uint32 targets[edges]             sorted within each node
+//         int32  weights[edges]             only if weighted
+//       or, if compressed, the lists of CompressedAdjacency:
+//         uint64 offsets[nodes + 2]         list of v is bytes offsets[v] to
+//                                           offsets[v + 1] - 1
+//         bytes  lists[offsets[nodes + 1]]  gaps (and weights) as varints
+//       Node names go to a separate <file>.names, one per line. Memory used
+//       while building is the memory limit plus the merge buffers; searches
+//       need memory for their per-node tables only.
+//       Edges are kept as given, including repeats; edges naming a node
+//       that is not on the graph, or from a node to itself, are skipped.
+//---------------------------------------------------------------------------
+#ifndef GRAPHX_H
+#define GRAPHX_H
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "compressedadjacency.h"
+using namespace std;
+
+const size_t DEFAULTMEMORY = 256 << 20; //Bytes of edges held before a run
+const int MAXMERGE = 64;                //Most runs merged in one pass
+
+class GraphX
+{
+public:
+  //Constructors
+  GraphX();
+  ~GraphX();
+  //Getters
+  bool depthFirstSearch(ostream &out = cout) const;
+  long long shortestDistance(const int fromNode, const int toNode) const;
+  long long getSize() const;
+  long long getEdgeCount() const;
+  double getCompressionRatio() const;
+  //Setters
+  bool buildGraph(ifstream &inFile, const string &fileName, const bool weighted,
+                  const size_t memoryLimit = DEFAULTMEMORY, const bool compressed = false);
+  bool open(const string &fileName);
+  void close();
+
+private:
+  struct Header
+  {
+    char magic[8];     //"GRAPHX1\0"
+    uint64_t nodes;    //Number of nodes, numbered from 1
+    uint64_t edges;    //Number of edges
+    uint64_t weighted; //1 if weights follow the targets
+    uint64_t compressed; //1 if the lists are CompressedAdjacency lists
+  };
+
+  struct Edge
+  {
+    uint32_t fromNode;
+    uint32_t toNode;
+    int32_t weight;
+    bool operator<(const Edge &rhs) const;
+  };
+
+  struct RunMerger;         //Reads several sorted runs as one, in order
+
+  struct EdgeCursor         //Position in the edges of one node
+  {
+    uint64_t next;          //Next edge, if not compressed
+    uint64_t end;
+    CompressedAdjacency::Cursor list; //Next edge, if compressed
+  };
+
+  int fd;                   //Adjacency file, -1 if none is open
+  void *mapped;             //Whole file, mapped read-only
+  size_t mappedSize;
+  long long size;           //Number of nodes
+  long long edgeCount;
+  bool weighted;
+  bool compressed;
+  const uint64_t *offsets;  //Sections of the mapped file
+  const uint32_t *targets;
+  const int32_t *weights;
+  const unsigned char *lists;
+
+  //Utility and Helper Functions
+  bool writeRun(vector<Edge> &edges, const string &runName) const;
+  bool mergeRuns(const vector<string> &runs, const string &outName) const;
+  bool writeAdjacency(const vector<string> &runs, const string &fileName,
+                      const long long nodes, const long long edges,
+                      const bool weighted, const bool compressed) const;
+  EdgeCursor edgesOf(const uint32_t v) const;
+  bool nextEdge(EdgeCursor &cursor, uint32_t &target, int &weight) const;
+};
+#endif
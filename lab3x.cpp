@@ -0,0 +1,287 @@
+//---------------------------------------------------------------------------
+// lab3x.cpp
+//---------------------------------------------------------------------------
+// This code checks GraphX against GraphM and GraphL. Every graph is built
+// both ways and the answers are compared: shortest distances between every
+// pair of nodes against GraphM, and which nodes can reach which against
+// GraphL. GraphX is given a memory limit of a few edges, so each build
+// writes many runs; the generated graphs need more than MAXMERGE runs, so
+// their runs are merged in more than one pass. One generated graph is a
+// long chain, so depth-first search must not recurse, and one is dense
+// enough that GraphL answers reachability by searching. Each graph is also built with
+// compressed lists, by GraphX, by GraphL::buildGraph, and by GraphL::compress
+// after building, and every answer is checked against the plain lists.
+//
+// Assumptions:
+//   -- text files "data31.txt" and "data32.txt" are formatted as described
+//   -- the current directory is writable; every file written there is
+//      removed before the program ends
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "graphl.h"
+#include "graphm.h"
+#include "graphx.h"
+using namespace std;
+
+const size_t TINYMEMORY = 32;     // room for two edges per run
+const size_t SMALLMEMORY = 768;   // room for 64 edges per run
+const size_t LARGEMEMORY = 98304; // room for 8192 edges per run
+const string ADJFILE = "lab3x.adj";
+const string ZIPFILE = "lab3x.zip.adj";
+const string TEXTFILE = "lab3x.txt";
+
+// next number of a fixed linear congruential sequence, so every run of
+// this program generates the same graphs
+unsigned lcg(unsigned &seed) {
+	seed = seed * 1103515245u + 12345u;
+	return (seed >> 16) & 0x7FFF;
+}
+
+// node from 1 to n, picked with lcg
+int pick(int n, unsigned &seed) {
+	unsigned high = lcg(seed);
+	return (int)((high << 15 | lcg(seed)) % n) + 1;
+}
+
+// true if a run or merge pass file was left behind by the last build
+bool leftovers() {
+	ifstream run((ADJFILE + ".run0").c_str());
+	ifstream pass((ADJFILE + ".pass0.0").c_str());
+	ifstream zipRun((ZIPFILE + ".run0").c_str());
+	ifstream zipPass((ZIPFILE + ".pass0.0").c_str());
+	return run.is_open() || pass.is_open() || zipRun.is_open() || zipPass.is_open();
+}
+
+// displayGraph output, with its lines sorted if sorted is true
+string display(const GraphL &G, bool sorted) {
+	ostringstream out;
+	G.displayGraph(out);
+	if (!sorted)
+		return out.str();
+	istringstream in(out.str());
+	vector<string> lines;
+	string line;
+	while (getline(in, line))
+		lines.push_back(line);
+	sort(lines.begin(), lines.end());
+	string all;
+	for (size_t i = 0; i < lines.size(); i++)
+		all += lines[i] + "\n";
+	return all;
+}
+
+// depthFirstSearch output
+template <class Graph>
+string search(const Graph &G) {
+	ostringstream out;
+	G.depthFirstSearch(out);
+	return out.str();
+}
+
+// number of ways the compressed forms of a graph differ from the plain
+// ones: C was built compressed and P compressed after building. Compressed
+// lists are sorted, so they must give the same depth-first ordering as
+// GraphX, and the same edges as L in a different order.
+int compareLists(const GraphL &L, const GraphL &C, const GraphL &P, const GraphX &X,
+                 const GraphX &XC) {
+	int differ = 0;
+	if (display(C, false) != display(P, false))
+		differ++;
+	if (display(C, true) != display(L, true))
+		differ++;
+	string order = search(X);
+	if (search(C) != order || search(P) != order || search(XC) != order)
+		differ++;
+	return differ;
+}
+
+// compression ratios, two decimal places
+void showRatios(const GraphL &C, const GraphX &XC) {
+	cout << fixed << setprecision(2) << "  compressed: lists " << C.getCompressionRatio()
+	     << " times smaller, file lists " << XC.getCompressionRatio() << " times smaller"
+	     << endl;
+}
+
+// number of node pairs whose shortest distance differs
+int compareDistances(const GraphM &M, const GraphX &X) {
+	int differ = 0;
+	for (int from = 1; from <= M.getSize(); from++) {
+		for (int to = 1; to <= M.getSize(); to++) {
+			int dist = M.shortestDistance(from, to);
+			long long expected = (dist == INFINITY) ? -1 : dist;
+			if (X.shortestDistance(from, to) != expected)
+				differ++;
+		}
+	}
+	return differ;
+}
+
+// number of node pairs, out of count (every pair if count is 0), where one
+// graph finds a path and the other does not
+int compareReach(const GraphL &L, const GraphX &X, int count, unsigned &seed) {
+	int differ = 0;
+	int n = L.getSize();
+	for (int i = 0; i < (count > 0 ? count : n * n); i++) {
+		int from = (count > 0) ? pick(n, seed) : i / n + 1;
+		int to = (count > 0) ? pick(n, seed) : i % n + 1;
+		if (L.reachable(from, to) != (X.shortestDistance(from, to) >= 0))
+			differ++;
+	}
+	return differ;
+}
+
+// checks the GraphL in TEXTFILE against GraphX, building it plain and
+// compressed both ways, GraphX runs holding memory bytes of edges; count
+// pairs are sampled for each reachability check
+int checkLists(const string &name, size_t memory, int count, unsigned &seed) {
+	ifstream in(TEXTFILE.c_str()), inX(TEXTFILE.c_str()), inZ(TEXTFILE.c_str());
+	ifstream inC(TEXTFILE.c_str()), inP(TEXTFILE.c_str());
+	GraphL L, C, P;
+	L.buildGraph(in);
+	C.buildGraph(inC, true);
+	P.buildGraph(inP);
+	P.compress();
+	GraphX X, XC;
+	X.buildGraph(inX, ADJFILE, false, memory);
+	XC.buildGraph(inZ, ZIPFILE, false, memory, true);
+	int differ = compareReach(L, X, count, seed) + compareReach(C, XC, count, seed);
+	differ += compareLists(L, C, P, X, XC);
+	cout << name << ": " << X.getSize() << " nodes, " << X.getEdgeCount()
+	     << " edges, " << differ << " answers differ, index "
+	     << L.getIndexSize() << " bytes" << endl;
+	showRatios(C, XC);
+	return differ + leftovers();
+}
+
+// writes a generated graph in the lab3 format: nodes, names, edges, zeros;
+// each edge goes from a node to one of the next span nodes, and one edge in
+// backEvery goes back instead, when backEvery is not 0
+void writeGraph(int nodes, int span, int percent, int backEvery, bool weighted,
+                unsigned &seed) {
+	ofstream out(TEXTFILE.c_str());
+	out << nodes << "\r\n";
+	for (int v = 1; v <= nodes; v++)
+		out << "node " << v << "\r\n";
+	int edges = 0;
+	for (int from = 1; from <= nodes; from++) {
+		for (int step = 1; step <= span; step++) {
+			if ((int)(lcg(seed) % 100) >= percent)
+				continue;
+			edges++;
+			bool back = backEvery > 0 && edges % backEvery == 0;
+			int to = back ? from - step : from + step;
+			if (span >= nodes)
+				to = (from + step - 1) % nodes + 1;
+			if (to < 1 || to > nodes || to == from)
+				continue;
+			out << from << " " << to;
+			if (weighted)
+				out << " " << lcg(seed) % 50 + 1;
+			out << "\r\n";
+		}
+	}
+	out << (weighted ? "0 0 0" : "0 0") << "\r\n";
+}
+
+int main() {
+	int failures = 0;
+	unsigned seed = 343;
+
+	// part 1, data31.txt against GraphM
+	ifstream infile1("data31.txt"), infileX1("data31.txt"), infileZ1("data31.txt");
+	if (!infile1 || !infileX1 || !infileZ1) {
+		cout << "File could not be opened." << endl;
+		return 1;
+	}
+	for (int g = 1;; g++) {
+		GraphM M;
+		M.buildGraph(infile1);
+		if (infile1.eof())
+			break;
+		GraphX X;
+		X.buildGraph(infileX1, ADJFILE, true, TINYMEMORY);
+		GraphX XC;
+		XC.buildGraph(infileZ1, ZIPFILE, true, TINYMEMORY, true);
+		int differ = compareDistances(M, X) + compareDistances(M, XC);
+		differ += search(X) != search(XC);
+		failures += differ + leftovers();
+		cout << "GraphM " << g << ": " << X.getSize() << " nodes, "
+		     << X.getEdgeCount() << " edges, " << differ << " answers differ" << endl;
+	}
+
+	// part 2, data32.txt against GraphL
+	ifstream infile2("data32.txt"), infileX2("data32.txt"), infileZ2("data32.txt");
+	ifstream infileC2("data32.txt"), infileP2("data32.txt");
+	if (!infile2 || !infileX2 || !infileZ2 || !infileC2 || !infileP2) {
+		cout << "File could not be opened." << endl;
+		return 1;
+	}
+	for (int g = 1;; g++) {
+		GraphL L;
+		L.buildGraph(infile2);
+		if (infile2.eof())
+			break;
+		GraphX X;
+		X.buildGraph(infileX2, ADJFILE, false, TINYMEMORY);
+		GraphX XC;
+		XC.buildGraph(infileZ2, ZIPFILE, false, TINYMEMORY, true);
+		GraphL C, P;
+		C.buildGraph(infileC2, true);
+		P.buildGraph(infileP2);
+		P.compress();
+		int differ = compareReach(L, X, 0, seed) + compareReach(C, XC, 0, seed);
+		differ += compareLists(L, C, P, X, XC);
+		failures += differ + leftovers();
+		cout << "GraphL " << g << ": " << X.getSize() << " nodes, "
+		     << X.getEdgeCount() << " edges, " << differ << " answers differ, index "
+		     << L.getIndexSize() << " bytes" << endl;
+		showRatios(C, XC);
+		X.depthFirstSearch();
+	}
+
+	// part 3, generated graphs too large for one merge pass
+	writeGraph(100, 100, 50, 0, true, seed);
+	{
+		ifstream in(TEXTFILE.c_str()), inX(TEXTFILE.c_str()), inZ(TEXTFILE.c_str());
+		GraphM M;
+		M.buildGraph(in);
+		GraphX X, XC;
+		X.buildGraph(inX, ADJFILE, true, SMALLMEMORY);
+		XC.buildGraph(inZ, ZIPFILE, true, SMALLMEMORY, true);
+		int differ = compareDistances(M, X) + compareDistances(M, XC);
+		differ += search(X) != search(XC);
+		failures += differ + leftovers();
+		cout << "Generated GraphM: " << X.getSize() << " nodes, " << X.getEdgeCount()
+		     << " edges, " << differ << " answers differ" << endl;
+		cout << fixed << setprecision(2) << "  compressed: file lists "
+		     << XC.getCompressionRatio() << " times smaller" << endl;
+	}
+	writeGraph(10000, 20, 15, 40, false, seed);
+	failures += checkLists("Generated GraphL", SMALLMEMORY, 2000, seed);
+
+	// part 4, a graph whose depth-first search goes 200000 nodes deep, far
+	// deeper than recursion on the call stack could go
+	writeGraph(200000, 2, 100, 0, false, seed);
+	failures += checkLists("Deep GraphL", LARGEMEMORY, 50, seed);
+
+	// part 5, a graph with edges so long that its 2-hop labels go over
+	// HOPBUDGET, so GraphL::reachable searches the condensed graph
+	writeGraph(15000, 1500, 1, 0, false, seed);
+	failures += checkLists("Dense GraphL", LARGEMEMORY, 500, seed);
+
+	remove(TEXTFILE.c_str());
+	remove(ADJFILE.c_str());
+	remove((ADJFILE + ".names").c_str());
+	remove(ZIPFILE.c_str());
+	remove((ZIPFILE + ".names").c_str());
+	cout << endl << (failures == 0 ? "GraphX matches." : "GraphX differs.") << endl;
+	return failures == 0 ? 0 : 1;
+}